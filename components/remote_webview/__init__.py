@@ -1,6 +1,7 @@
 import re
 import esphome.codegen as cg
 import esphome.config_validation as cv
+import esphome.final_validate as fv
 from esphome.components import display, touchscreen
 from esphome.components.display import validate_rotation
 from esphome.const import CONF_ID, CONF_DISPLAY_ID, CONF_URL, CONF_ROTATION
@@ -18,6 +19,18 @@ CONF_MIN_FRAME_INTERVAL = "min_frame_interval"
 CONF_JPEG_QUALITY = "jpeg_quality"
 CONF_MAX_BYTES_PER_MSG = "max_bytes_per_msg"
 CONF_BIG_ENDIAN = "big_endian"
+CONF_GESTURE_SCALE = "gesture_scale"
+CONF_PREVIEW_QUALITY = "preview_quality"
+CONF_LATENCY_STATS = "latency_stats"
+CONF_MEMORY_BUDGET = "memory_budget"
+CONF_DECODE_WORKERS = "decode_workers"
+CONF_PIXEL_FORMAT = "pixel_format"
+CONF_ASYNC_BLIT = "async_blit"
+CONF_AUTO_CALIBRATE = "auto_calibrate"
+CONF_CONTROL_CHANNEL = "control_channel"
+CONF_TOUCH_PRIORITY = "touch_priority"
+CONF_GLYPH_CACHE = "glyph_cache"
+CONF_VIDEO_REGION = "video_region"
 
 _SERVER_RE = re.compile(
     r"^(?P<host>[A-Za-z0-9](?:[A-Za-z0-9\-\.]*[A-Za-z0-9])?)\:(?P<port>\d{1,5})$"
@@ -25,6 +38,7 @@ _SERVER_RE = re.compile(
 
 AUTO_LOAD = []
 DEPENDENCIES = ["display"]
+MULTI_CONF = True
 
 def validate_host_port(value):
     s = cv.string_strict(value).strip()
@@ -42,6 +56,14 @@ def validate_host_port(value):
 
 ns = cg.esphome_ns.namespace("remote_webview")
 RemoteWebView = ns.class_("RemoteWebView", cg.Component)
+PixelFormat = ns.enum("PixelFormat", is_class=True)
+PIXEL_FORMATS = {
+    "RGB565": PixelFormat.RGB565,
+    "RGB332": PixelFormat.RGB332,
+    "GRAY8": PixelFormat.GRAY8,
+    "GRAY4": PixelFormat.GRAY4,
+    "MONO": PixelFormat.MONO,
+}
 
 CONFIG_SCHEMA = cv.Schema(
     {
@@ -62,9 +84,38 @@ CONFIG_SCHEMA = cv.Schema(
         cv.Optional(CONF_MAX_BYTES_PER_MSG): cv.int_,
         cv.Optional(CONF_BIG_ENDIAN): cv.boolean,
         cv.Optional(CONF_ROTATION): validate_rotation,
+        cv.Optional(CONF_GESTURE_SCALE): cv.one_of(1, 2, 4, 8, int=True),
+        cv.Optional(CONF_PREVIEW_QUALITY): cv.int_range(min=1, max=100),
+        cv.Optional(CONF_LATENCY_STATS): cv.boolean,
+        cv.Optional(CONF_MEMORY_BUDGET): cv.int_range(min=16 * 1024),
+        cv.Optional(CONF_DECODE_WORKERS): cv.int_range(min=1, max=2),
+        cv.Optional(CONF_PIXEL_FORMAT): cv.enum(PIXEL_FORMATS, upper=True),
+        cv.Optional(CONF_ASYNC_BLIT): cv.boolean,
+        cv.Optional(CONF_AUTO_CALIBRATE): cv.boolean,
+        cv.Optional(CONF_CONTROL_CHANNEL): cv.boolean,
+        cv.Optional(CONF_TOUCH_PRIORITY): cv.boolean,
+        cv.Optional(CONF_GLYPH_CACHE): cv.boolean,
+        cv.Optional(CONF_VIDEO_REGION): cv.boolean,
     }
 ).extend(cv.COMPONENT_SCHEMA)
 
+def _final_validate(config):
+    # the server keeps one session per device_id, so views sharing an id would take over each other's stream
+    views = fv.full_config.get().get("remote_webview", [])
+    if len(views) < 2:
+        return config
+    if CONF_DEVICE_ID not in config:
+        raise cv.Invalid(
+            "device_id is required on every remote_webview when more than one is configured"
+        )
+    if sum(1 for v in views if v.get(CONF_DEVICE_ID) == config[CONF_DEVICE_ID]) > 1:
+        raise cv.Invalid(
+            f"device_id '{config[CONF_DEVICE_ID]}' is used by more than one remote_webview"
+        )
+    return config
+
+FINAL_VALIDATE_SCHEMA = _final_validate
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
 
@@ -99,6 +150,30 @@ async def to_code(config):
         cg.add(var.set_big_endian(config[CONF_BIG_ENDIAN]))
     if CONF_ROTATION in config:
         cg.add(var.set_rotation(config[CONF_ROTATION]))
+    if CONF_GESTURE_SCALE in config:
+        cg.add(var.set_gesture_scale(config[CONF_GESTURE_SCALE]))
+    if CONF_PREVIEW_QUALITY in config:
+        cg.add(var.set_preview_quality(config[CONF_PREVIEW_QUALITY]))
+    if CONF_LATENCY_STATS in config:
+        cg.add(var.set_latency_stats(config[CONF_LATENCY_STATS]))
+    if CONF_MEMORY_BUDGET in config:
+        cg.add(var.set_memory_budget(config[CONF_MEMORY_BUDGET]))
+    if CONF_DECODE_WORKERS in config:
+        cg.add(var.set_decode_workers(config[CONF_DECODE_WORKERS]))
+    if CONF_PIXEL_FORMAT in config:
+        cg.add(var.set_pixel_format(config[CONF_PIXEL_FORMAT]))
+    if CONF_ASYNC_BLIT in config:
+        cg.add(var.set_async_blit(config[CONF_ASYNC_BLIT]))
+    if CONF_AUTO_CALIBRATE in config:
+        cg.add(var.set_auto_calibrate(config[CONF_AUTO_CALIBRATE]))
+    if CONF_CONTROL_CHANNEL in config:
+        cg.add(var.set_control_channel(config[CONF_CONTROL_CHANNEL]))
+    if CONF_TOUCH_PRIORITY in config:
+        cg.add(var.set_touch_priority(config[CONF_TOUCH_PRIORITY]))
+    if CONF_GLYPH_CACHE in config:
+        cg.add(var.set_glyph_cache(config[CONF_GLYPH_CACHE]))
+    if CONF_VIDEO_REGION in config:
+        cg.add(var.set_video_region(config[CONF_VIDEO_REGION]))
 
 
     await cg.register_component(var, config)
@@ -0,0 +1,87 @@
+#include "blit_stage.h"
+#include "esphome/core/log.h"
+
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+namespace esphome {
+namespace remote_webview {
+
+static const char *const TAG = "Remote_WebView";
+
+bool BlitStage::start(display::Display *display, size_t strip_bytes, int core, int prio) {
+  display_ = display;
+  strip_bytes_ = strip_bytes;
+
+  for (auto &s : strips_) {
+    // DMA-capable internal RAM lets SPI drivers transfer straight from the strip
+    s = (uint8_t *)heap_caps_malloc(strip_bytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!s) s = (uint8_t *)heap_caps_malloc(strip_bytes, MALLOC_CAP_8BIT);
+    if (!s) {
+      ESP_LOGE(TAG, "malloc %u for blit strip failed", (unsigned)strip_bytes);
+      return false;
+    }
+  }
+
+  q_free_ = xQueueCreate(kStrips, sizeof(uint8_t *));
+  q_jobs_ = xQueueCreate(kStrips, sizeof(Job));
+  if (!q_free_ || !q_jobs_) return false;
+  for (auto *s : strips_) xQueueSend(q_free_, &s, 0);
+
+  if (xTaskCreatePinnedToCore(&BlitStage::task_tramp_, "rwv_blit", 4096, this, prio, &task_, core) != pdPASS) {
+    task_ = nullptr;
+    return false;
+  }
+  return true;
+}
+
+uint8_t *BlitStage::acquire() {
+  uint8_t *buf = nullptr;
+  if (xQueueReceive(q_free_, &buf, 0) == pdTRUE) return buf;
+
+  const uint64_t t0 = esp_timer_get_time();
+  xQueueReceive(q_free_, &buf, portMAX_DELAY);
+  stats_.stall_us += esp_timer_get_time() - t0;
+  return buf;
+}
+
+void BlitStage::submit(uint8_t *buf, int x, int y, int w, int h, display::ColorBitness bitness, bool big_endian) {
+  Job j{buf, (int16_t)x, (int16_t)y, (uint16_t)w, (uint16_t)h, bitness, big_endian};
+  xQueueSend(q_jobs_, &j, portMAX_DELAY);
+}
+
+void BlitStage::flush() {
+  if (!task_) return;
+
+  // every strip is back in the free queue once the panel has taken it
+  const uint64_t t0 = esp_timer_get_time();
+  uint8_t *held[kStrips];
+  for (auto &h : held) xQueueReceive(q_free_, &h, portMAX_DELAY);
+  for (auto *h : held) xQueueSend(q_free_, &h, 0);
+  stats_.stall_us += esp_timer_get_time() - t0;
+}
+
+BlitStage::Stats BlitStage::take_stats() {
+  Stats s = stats_;
+  stats_ = Stats{};
+  return s;
+}
+
+void BlitStage::task_tramp_(void *arg) {
+  auto *self = reinterpret_cast<BlitStage *>(arg);
+  Job j;
+  for (;;) {
+    if (xQueueReceive(self->q_jobs_, &j, portMAX_DELAY) != pdTRUE) continue;
+
+    const uint64_t t0 = esp_timer_get_time();
+    self->display_->draw_pixels_at(j.x, j.y, j.w, j.h, j.buf, display::COLOR_ORDER_RGB, j.bitness, j.big_endian);
+    self->stats_.busy_us += esp_timer_get_time() - t0;
+    self->stats_.strips++;
+    self->stats_.bytes += (size_t)j.w * j.h * (j.bitness == display::COLOR_BITNESS_332 ? 1u : 2u);
+
+    xQueueSend(self->q_free_, &j.buf, portMAX_DELAY);
+  }
+}
+
+}  // namespace remote_webview
+}  // namespace esphome
@@ -0,0 +1,60 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "esphome/components/display/display.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+namespace esphome {
+namespace remote_webview {
+
+// Double-buffered output stage: the decoder fills one strip while a separate
+// task pushes the other to the panel, so decode and bus transfer overlap.
+class BlitStage {
+ public:
+  static constexpr int kStrips = 2;
+
+  struct Stats {
+    uint64_t busy_us{0};   // time the blit task spent inside draw_pixels_at
+    uint64_t stall_us{0};  // time the decoder waited for a strip or a flush
+    uint32_t strips{0};
+    uint64_t bytes{0};
+  };
+
+  bool start(display::Display *display, size_t strip_bytes, int core, int prio);
+  bool running() const { return task_ != nullptr; }
+  size_t strip_bytes() const { return strip_bytes_; }
+
+  // Blocks until the blit task hands a strip back.
+  uint8_t *acquire();
+  void submit(uint8_t *buf, int x, int y, int w, int h, display::ColorBitness bitness, bool big_endian);
+  // Waits until every submitted strip is on the panel.
+  void flush();
+
+  Stats take_stats();
+
+ private:
+  struct Job {
+    uint8_t *buf;
+    int16_t x, y;
+    uint16_t w, h;
+    display::ColorBitness bitness;
+    bool big_endian;
+  };
+
+  static void task_tramp_(void *arg);
+
+  display::Display *display_{nullptr};
+  size_t strip_bytes_{0};
+  uint8_t *strips_[kStrips]{};
+  QueueHandle_t q_free_{nullptr};
+  QueueHandle_t q_jobs_{nullptr};
+  TaskHandle_t task_{nullptr};
+  Stats stats_{};
+};
+
+}  // namespace remote_webview
+}  // namespace esphome
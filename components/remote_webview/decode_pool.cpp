@@ -0,0 +1,83 @@
+#include "decode_pool.h"
+#include "remote_webview.h"
+#include "remote_webview_config.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <stdio.h>
+
+namespace esphome {
+namespace remote_webview {
+
+static const char *const TAG = "Remote_WebView";
+
+DecodePool &DecodePool::instance() {
+  static DecodePool pool;
+  return pool;
+}
+
+int DecodePool::attach(RemoteWebView *view, const MemoryPlan &plan, int workers) {
+  // the first view to ask for more workers wins; views are spread round-robin
+  if (workers <= 0) workers = cfg::decode_pool_workers;
+  max_workers_ = std::max(max_workers_, std::min(workers, kMaxWorkers));
+
+  if (n_workers_ < max_workers_) {
+    if (!start_worker_(workers_[n_workers_], plan, n_workers_)) {
+      if (!n_workers_) return -1;
+    } else {
+      n_workers_++;
+    }
+  }
+
+  for (int tries = 0; tries < n_workers_; tries++) {
+    const int idx = next_worker_;
+    next_worker_ = (next_worker_ + 1) % n_workers_;
+    Worker &w = workers_[idx];
+    if (w.n_views < kMaxViews) {
+      w.views[w.n_views++] = view;
+      return idx;
+    }
+  }
+  return -1;
+}
+
+void DecodePool::notify(int worker) {
+  if (worker < 0 || worker >= n_workers_) return;
+  xSemaphoreGive(workers_[worker].work);
+}
+
+bool DecodePool::start_worker_(Worker &w, const MemoryPlan &plan, int index) {
+  w.work = xSemaphoreCreateCounting(kMaxViews * 64, 0);
+  if (!w.work) return false;
+
+  char name[16];
+  snprintf(name, sizeof(name), "rwv_decode%d", index);
+  const int core = index == 0 ? plan.decode_core : plan.decode_core_alt;
+  const int prio = index == 0 ? plan.decode_prio : plan.decode_prio_alt;
+  if (xTaskCreatePinnedToCore(&DecodePool::worker_tramp_, name, plan.decode_task_stack, &w, prio, &w.task, core) !=
+      pdPASS) {
+    ESP_LOGE(TAG, "failed to start decode worker %d", index);
+    return false;
+  }
+  return true;
+}
+
+void DecodePool::worker_tramp_(void *arg) {
+  auto *w = reinterpret_cast<Worker *>(arg);
+  for (;;) {
+    if (xSemaphoreTake(w->work, portMAX_DELAY) != pdTRUE) continue;
+
+    // one message per wake-up, rotating over views so a busy one cannot starve the others
+    const int n = w->n_views;
+    for (int i = 0; i < n; i++) {
+      RemoteWebView *v = w->views[(w->next + i) % n];
+      if (v->decode_next_()) {
+        w->next = (w->next + i + 1) % n;
+        break;
+      }
+    }
+  }
+}
+
+}  // namespace remote_webview
+}  // namespace esphome
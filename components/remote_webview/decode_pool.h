@@ -0,0 +1,50 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "memory_plan.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+namespace esphome {
+namespace remote_webview {
+
+class RemoteWebView;
+
+// Decode tasks shared by all RemoteWebView instances. Each view keeps its own
+// queue and is bound to one worker, so per-view ordering holds while several
+// views share a single 32 KB decode stack.
+class DecodePool {
+ public:
+  static constexpr int kMaxWorkers = 2;
+  static constexpr int kMaxViews = 4;
+
+  static DecodePool &instance();
+
+  // Binds the view to a worker, starting it if needed; returns the worker index or -1.
+  int attach(RemoteWebView *view, const MemoryPlan &plan, int workers);
+  void notify(int worker);
+  int workers() const { return n_workers_; }
+
+ private:
+  struct Worker {
+    SemaphoreHandle_t work{nullptr};
+    TaskHandle_t task{nullptr};
+    RemoteWebView *views[kMaxViews]{};
+    int n_views{0};
+    int next{0};
+  };
+
+  bool start_worker_(Worker &w, const MemoryPlan &plan, int index);
+  static void worker_tramp_(void *arg);
+
+  Worker workers_[kMaxWorkers];
+  int n_workers_{0};
+  int max_workers_{0};
+  int next_worker_{0};
+};
+
+}  // namespace remote_webview
+}  // namespace esphome
@@ -0,0 +1,169 @@
+#include "glyph_cache.h"
+
+#include "esp_heap_caps.h"
+
+#include <string.h>
+
+namespace esphome {
+namespace remote_webview {
+
+static void *psram_calloc_(size_t n, size_t sz) {
+  return heap_caps_calloc(n, sz, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+}
+
+// blends color into dst (native RGB565) through an 8-bit coverage mask
+static void blend_a8_565_(uint16_t *dst, size_t dst_stride, const uint8_t *alpha, size_t alpha_stride, int w, int h,
+                          uint16_t color) {
+  const int fr = color >> 11, fg = (color >> 5) & 0x3F, fb = color & 0x1F;
+  for (int y = 0; y < h; y++) {
+    uint16_t *d = dst + (size_t)y * dst_stride;
+    const uint8_t *a = alpha + (size_t)y * alpha_stride;
+    for (int x = 0; x < w; x++) {
+      const int k = a[x];
+      if (!k) continue;
+      if (k == 255) { d[x] = color; continue; }
+      const int br = d[x] >> 11, bg = (d[x] >> 5) & 0x3F, bb = d[x] & 0x1F;
+      const int r = br + ((fr - br) * k + 127) / 255;
+      const int g = bg + ((fg - bg) * k + 127) / 255;
+      const int b = bb + ((fb - bb) * k + 127) / 255;
+      d[x] = (uint16_t)((r << 11) | (g << 5) | b);
+    }
+  }
+}
+
+bool GlyphCache::init(size_t atlas_bytes, size_t max_glyphs, size_t bg_bytes, size_t bg_slots, size_t scratch_px) {
+  atlas_ = (uint8_t *)psram_calloc_(atlas_bytes, 1);
+  glyphs_ = (Glyph *)psram_calloc_(max_glyphs, sizeof(Glyph));
+  bg_pixels_ = (uint16_t *)psram_calloc_(bg_bytes / 2, sizeof(uint16_t));
+  bgs_ = (Background *)psram_calloc_(bg_slots, sizeof(Background));
+  scratch_ = (uint16_t *)psram_calloc_(scratch_px, sizeof(uint16_t));
+
+  if (!atlas_ || !glyphs_ || !bg_pixels_ || !bgs_ || !scratch_) {
+    heap_caps_free(atlas_);
+    heap_caps_free(glyphs_);
+    heap_caps_free(bg_pixels_);
+    heap_caps_free(bgs_);
+    heap_caps_free(scratch_);
+    atlas_ = nullptr; glyphs_ = nullptr; bg_pixels_ = nullptr; bgs_ = nullptr; scratch_ = nullptr;
+    return false;
+  }
+
+  atlas_bytes_ = atlas_bytes;
+  max_glyphs_ = max_glyphs;
+  bg_px_ = bg_bytes / 2;
+  bg_slots_ = bg_slots;
+  scratch_px_ = scratch_px;
+  return true;
+}
+
+void GlyphCache::clear() {
+  if (!ready()) return;
+  memset(glyphs_, 0, max_glyphs_ * sizeof(Glyph));
+  memset(bgs_, 0, bg_slots_ * sizeof(Background));
+  atlas_used_ = 0;
+  glyph_count_ = 0;
+  bg_used_px_ = 0;
+}
+
+bool GlyphCache::put_glyph(uint16_t id, uint8_t w, uint8_t h, const uint8_t *alpha) {
+  if (!ready() || id >= max_glyphs_ || !w || !h) {
+    stats_.rejected++;
+    return false;
+  }
+
+  const size_t n = (size_t)w * h;
+  Glyph &g = glyphs_[id];
+  // re-uploads of the same size overwrite in place; anything else takes fresh atlas space
+  if (!g.w || (size_t)g.w * g.h != n) {
+    if (atlas_used_ + n > atlas_bytes_) {
+      stats_.rejected++;
+      return false;
+    }
+    if (!g.w) glyph_count_++;
+    g.off = (uint32_t)atlas_used_;
+    atlas_used_ += n;
+  }
+  g.w = w;
+  g.h = h;
+  memcpy(atlas_ + g.off, alpha, n);
+  return true;
+}
+
+bool GlyphCache::put_background(const proto::BackgroundInfo &bg) {
+  const size_t n = (size_t)bg.w * bg.h;
+  if (!ready() || bg.bg_id >= bg_slots_ || !n) {
+    stats_.rejected++;
+    return false;
+  }
+
+  Background &b = bgs_[bg.bg_id];
+  if (b.cap_px < n) {
+    if (bg_used_px_ + n > bg_px_) {
+      stats_.rejected++;
+      return false;
+    }
+    b.off = (uint32_t)bg_used_px_;
+    b.cap_px = (uint32_t)n;
+    bg_used_px_ += n;
+  }
+  b.x = bg.x; b.y = bg.y; b.w = bg.w; b.h = bg.h;
+
+  uint16_t *dst = bg_pixels_ + b.off;
+  for (size_t i = 0; i < n; i++) dst[i] = proto::rd16(bg.pixels + i * 2);
+  return true;
+}
+
+const uint16_t *GlyphCache::compose(const proto::TextRunInfo &run) {
+  const size_t n = (size_t)run.w * run.h;
+  if (!ready() || !n || n > scratch_px_) {
+    stats_.rejected++;
+    return nullptr;
+  }
+
+  // background: a cached rect covering the run, else the solid fallback color
+  const Background *b = run.bg_id < bg_slots_ ? &bgs_[run.bg_id] : nullptr;
+  const bool have_bg = b && b->cap_px && run.x >= b->x && run.y >= b->y && run.x + run.w <= b->x + b->w &&
+                       run.y + run.h <= b->y + b->h;
+  if (have_bg) {
+    const uint16_t *src = bg_pixels_ + b->off + (size_t)(run.y - b->y) * b->w + (run.x - b->x);
+    for (uint16_t r = 0; r < run.h; r++) memcpy(scratch_ + (size_t)r * run.w, src + (size_t)r * b->w, (size_t)run.w * 2u);
+  } else {
+    if (run.bg_id != proto::kNoBackground) stats_.bg_misses++;
+    for (size_t i = 0; i < n; i++) scratch_[i] = run.bg_color;
+  }
+
+  for (uint16_t i = 0; i < run.count; i++) {
+    const uint8_t *e = run.glyphs + (size_t)i * sizeof(proto::TextRunGlyph);
+    const uint16_t id = proto::rd16(e);
+    const int dx = (int16_t)proto::rd16(e + 2), dy = (int16_t)proto::rd16(e + 4);
+    const uint16_t color = proto::rd16(e + 6);
+
+    if (id >= max_glyphs_ || !glyphs_[id].w) {
+      stats_.glyph_misses++;
+      continue;
+    }
+    const Glyph &g = glyphs_[id];
+
+    // clip the glyph box to the run
+    const int x0 = dx < 0 ? 0 : dx, y0 = dy < 0 ? 0 : dy;
+    const int x1 = dx + g.w > run.w ? run.w : dx + g.w;
+    const int y1 = dy + g.h > run.h ? run.h : dy + g.h;
+    if (x0 >= x1 || y0 >= y1) continue;
+
+    const uint8_t *alpha = atlas_ + g.off + (size_t)(y0 - dy) * g.w + (x0 - dx);
+    blend_a8_565_(scratch_ + (size_t)y0 * run.w + x0, run.w, alpha, g.w, x1 - x0, y1 - y0, color);
+  }
+
+  stats_.runs++;
+  stats_.run_bytes += (uint32_t)(sizeof(proto::TextRunHeader) + (size_t)run.count * sizeof(proto::TextRunGlyph));
+  return scratch_;
+}
+
+GlyphCache::Stats GlyphCache::take_stats() {
+  const Stats s = stats_;
+  stats_ = Stats{};
+  return s;
+}
+
+}  // namespace remote_webview
+}  // namespace esphome
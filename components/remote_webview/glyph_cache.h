@@ -0,0 +1,69 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "protocol.h"
+
+namespace esphome {
+namespace remote_webview {
+
+// Server-uploaded glyph coverage masks plus cached background rects, both in PSRAM.
+// A text run is rebuilt from these into a scratch RGB565 buffer, so a changing
+// number costs a few bytes per glyph on the wire instead of a re-encoded tile.
+// Only touched from the decode task.
+class GlyphCache {
+ public:
+  struct Stats {
+    uint32_t runs{0};
+    uint32_t run_bytes{0};
+    uint32_t glyph_misses{0};
+    uint32_t bg_misses{0};
+    uint32_t rejected{0};  // uploads that did not fit
+  };
+
+  bool init(size_t atlas_bytes, size_t max_glyphs, size_t bg_bytes, size_t bg_slots, size_t scratch_px);
+  bool ready() const { return atlas_ != nullptr; }
+  // forget everything; glyph ids are only meaningful within one server session
+  void clear();
+
+  bool put_glyph(uint16_t id, uint8_t w, uint8_t h, const uint8_t *alpha);
+  bool put_background(const proto::BackgroundInfo &bg);
+  // Composites the run into the scratch buffer (native RGB565, run.w x run.h) and returns it.
+  const uint16_t *compose(const proto::TextRunInfo &run);
+
+  size_t atlas_used() const { return atlas_used_; }
+  size_t glyph_count() const { return glyph_count_; }
+  Stats take_stats();
+
+ private:
+  struct Glyph {
+    uint32_t off;
+    uint8_t w, h;
+  };
+  struct Background {
+    uint32_t off;
+    uint32_t cap_px;
+    uint16_t x, y, w, h;
+  };
+
+  uint8_t *atlas_{nullptr};
+  size_t atlas_bytes_{0};
+  size_t atlas_used_{0};
+  Glyph *glyphs_{nullptr};  // indexed by glyph id; w == 0 means empty
+  size_t max_glyphs_{0};
+  size_t glyph_count_{0};
+
+  uint16_t *bg_pixels_{nullptr};
+  size_t bg_px_{0};
+  size_t bg_used_px_{0};
+  Background *bgs_{nullptr};  // indexed by bg id; cap_px == 0 means empty
+  size_t bg_slots_{0};
+
+  uint16_t *scratch_{nullptr};
+  size_t scratch_px_{0};
+
+  Stats stats_;
+};
+
+}  // namespace remote_webview
+}  // namespace esphome
@@ -0,0 +1,90 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+namespace esphome {
+namespace remote_webview {
+
+// Fixed-bucket histogram, cheap enough to update from the decode task on every frame.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBuckets = 12;
+
+  void add(uint32_t us) {
+    const uint32_t ms = us / 1000u;
+    size_t i = 0;
+    while (i + 1 < kBuckets && ms > kEdgesMs[i]) i++;
+    counts_[i]++;
+    n_++;
+    if (us > max_us_) max_us_ = us;
+  }
+
+  // upper edge of the bucket holding the pct-th sample, never above the largest sample seen
+  uint32_t percentile_ms(uint8_t pct) const {
+    if (!n_) return 0;
+    const uint32_t target = (uint32_t)(((uint64_t)n_ * pct + 99) / 100);
+    uint32_t seen = 0;
+    for (size_t i = 0; i + 1 < kBuckets; i++) {
+      seen += counts_[i];
+      if (seen >= target) return kEdgesMs[i] < max_ms() ? kEdgesMs[i] : max_ms();
+    }
+    return max_ms();
+  }
+
+  uint32_t count() const { return n_; }
+  uint32_t max_ms() const { return max_us_ / 1000u; }
+
+  void reset() {
+    for (auto &c : counts_) c = 0;
+    n_ = 0;
+    max_us_ = 0;
+  }
+
+ private:
+  static constexpr uint32_t kEdgesMs[kBuckets] = {8, 16, 25, 33, 50, 66, 100, 150, 250, 500, 1000, 0xffffffffu};
+  uint32_t counts_[kBuckets]{};
+  uint32_t n_{0};
+  uint32_t max_us_{0};
+};
+
+// NTP-style offset estimate (server clock minus client clock), taken from the
+// lowest-RTT sample of the recent window since queueing delay only ever adds.
+class ClockSync {
+ public:
+  static constexpr size_t kWindow = 8;
+
+  void add_sample(uint64_t t0, uint64_t t1, uint64_t t2, uint64_t t3) {
+    if (t3 < t0 || t2 < t1) return;
+    const uint64_t rtt = (t3 - t0) - (t2 - t1);
+    Sample &s = samples_[next_++ % kWindow];
+    s.rtt_us = rtt > 0xffffffffu ? 0xffffffffu : (uint32_t)rtt;
+    s.offset_us = (((int64_t)t1 - (int64_t)t0) + ((int64_t)t2 - (int64_t)t3)) / 2;
+    if (filled_ < kWindow) filled_++;
+
+    size_t best = 0;
+    for (size_t i = 1; i < filled_; i++)
+      if (samples_[i].rtt_us < samples_[best].rtt_us) best = i;
+    rtt_us_ = samples_[best].rtt_us;
+    offset_us_ = samples_[best].offset_us;
+  }
+
+  bool valid() const { return filled_ > 0; }
+  uint32_t rtt_us() const { return rtt_us_; }
+  int64_t offset_us() const { return offset_us_; }
+  uint64_t to_client_us(uint64_t server_us) const { return (uint64_t)((int64_t)server_us - offset_us_); }
+  void reset() { filled_ = 0; next_ = 0; rtt_us_ = 0; offset_us_ = 0; }
+
+ private:
+  struct Sample {
+    uint32_t rtt_us;
+    int64_t offset_us;
+  };
+  Sample samples_[kWindow]{};
+  size_t filled_{0};
+  size_t next_{0};
+  uint32_t rtt_us_{0};
+  int64_t offset_us_{0};
+};
+
+}  // namespace remote_webview
+}  // namespace esphome
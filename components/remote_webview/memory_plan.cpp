@@ -0,0 +1,113 @@
+#include "memory_plan.h"
+#include "remote_webview_config.h"
+
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+
+#include <algorithm>
+
+namespace esphome {
+namespace remote_webview {
+
+MemoryPlan plan_memory(const PlanRequest &req) {
+  MemoryPlan p;
+  p.free_internal = heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  p.free_psram    = heap_caps_get_free_size(MALLOC_CAP_SPIRAM);
+
+  const bool has_psram = p.free_psram >= cfg::plan_min_psram;
+  const size_t bulk_free = has_psram ? p.free_psram : p.free_internal;
+  const bool tight = p.free_internal < cfg::plan_tight_internal;
+
+  p.max_message_bytes = req.max_bytes_per_msg > 0 ? (size_t)req.max_bytes_per_msg : cfg::ws_max_message_bytes;
+  p.ws_task_stack     = cfg::ws_task_stack;
+  p.decode_task_stack = cfg::decode_task_stack;
+  p.ws_prio           = cfg::ws_task_prio;
+  p.ctl_prio          = cfg::ws_ctl_task_prio;
+  p.decode_prio       = cfg::decode_task_prio;
+  // whatever shares core 0 with the socket task runs below it, so reassembly is never starved
+  p.decode_prio_alt   = cfg::ws_task_prio - 1;
+  p.blit_prio         = cfg::ws_task_prio - 1;
+
+  // internal RAM also feeds Wi-Fi/lwIP: a reserve stays untouched, the rest can hold stacks and buffers
+  size_t internal_left = p.free_internal > cfg::plan_internal_reserve ? p.free_internal - cfg::plan_internal_reserve : 0;
+
+  // fixed costs first: the tasks and socket buffer the stream cannot run without; a smaller
+  // socket buffer is the only thing that can give
+  p.ws_buffer_size = std::min(tight ? cfg::ws_buffer_size_min : cfg::ws_buffer_size, p.max_message_bytes);
+  const size_t fixed_full = p.ws_task_stack + p.ws_buffer_size + p.decode_task_stack;
+  if (fixed_full > internal_left || (req.budget > 0 && fixed_full > (size_t)req.budget))
+    p.ws_buffer_size = std::min(cfg::ws_buffer_size_min, p.max_message_bytes);
+  p.fixed_bytes = p.ws_task_stack + p.ws_buffer_size + p.decode_task_stack;
+
+  // an explicit budget covers everything; "auto" is a quarter of the bulk heap on top of the fixed costs
+  p.budget = req.budget > 0 ? std::min((size_t)req.budget, bulk_free) : p.fixed_bytes + bulk_free / 4;
+  p.fixed_fits = p.fixed_bytes <= internal_left && p.fixed_bytes <= p.budget;
+  if (!p.fixed_fits) return p;
+  internal_left -= p.fixed_bytes;
+  p.used = p.fixed_bytes;
+
+  // optional pieces compete for a quarter of internal RAM, or for all of it above the reserve
+  // when the budget was set explicitly
+  if (req.budget <= 0) internal_left = std::min(internal_left, p.free_internal / 4);
+
+  size_t left = p.budget - p.fixed_bytes;
+  auto take = [&](size_t bytes, bool internal) {
+    if (bytes > left || (internal && bytes > internal_left)) return false;
+    left -= bytes;
+    if (internal) internal_left -= bytes;
+    p.used += bytes;
+    return true;
+  };
+
+  // strips are a share of the budget, capped by what the panel driver can use and by internal RAM
+  const size_t strip_share = std::min({cfg::strip_buffer_max, p.budget / 8, internal_left / 2});
+  p.strip_buffer_bytes = take(strip_share, true) ? strip_share : 0;
+
+  if (req.control_channel) {
+    p.ctl_task_stack  = cfg::ws_task_stack;
+    p.ctl_buffer_size = cfg::ws_ctl_buffer_size;
+    p.control_channel = take(p.ctl_task_stack + p.ctl_buffer_size, true);
+  }
+
+  // the blit task needs its own stack and both strips to be worth it
+  if (req.async_blit && !tight && p.strip_buffer_bytes)
+    p.async_blit = take(cfg::ws_task_stack, true);
+
+  if (req.glyph_cache && has_psram) {
+    p.glyph_bytes = cfg::glyph_atlas_bytes + cfg::glyph_bg_bytes + cfg::glyph_run_max_px * 2u;
+    // never let text starve the frame stream of its reassembly slots
+    p.glyph_cache = p.glyph_bytes <= left / 2 && take(p.glyph_bytes, false);
+    if (!p.glyph_cache) p.glyph_bytes = 0;
+  }
+
+  int workers = req.decode_workers > 0 ? req.decode_workers : cfg::decode_pool_workers;
+  p.decode_workers = 1;
+  if (workers > 1 && portNUM_PROCESSORS > 1 && !tight && take(p.decode_task_stack, true))
+    p.decode_workers = 2;
+
+  // whatever is left holds whole messages: one being reassembled, one decoding, the rest queued
+  p.msg_pool_psram = has_psram;
+  p.video_slots = req.video_region ? cfg::video_queue_depth : 0;
+  const size_t pool_room = has_psram ? left : std::min(left, internal_left);
+  const size_t slots = std::min(pool_room * 3 / 4 / p.max_message_bytes, cfg::msg_pool_slots_max);
+  p.decode_queue_depth = std::max(2, (int)slots - 2 - p.video_slots);
+  p.msg_pool_slots = slots >= 3 && take(slots * p.max_message_bytes, !has_psram) ? slots : 0;  // else malloc
+
+  // Wi-Fi and lwIP live on core 0, so socket tasks sit next to them and decoding gets core 1 to
+  // itself; the blit task and a second worker take the protocol core's idle time.
+#if portNUM_PROCESSORS > 1
+  p.ws_core         = 0;
+  p.decode_core     = 1;
+  p.decode_core_alt = 0;
+  p.blit_core       = 0;
+#else
+  p.ws_core         = 0;
+  p.decode_core     = 0;
+  p.decode_core_alt = 0;
+  p.blit_core       = 0;
+#endif
+  return p;
+}
+
+}  // namespace remote_webview
+}  // namespace esphome
@@ -0,0 +1,64 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace esphome {
+namespace remote_webview {
+
+// What the view would like to run; the plan decides how much of it fits.
+struct PlanRequest {
+  long budget{-1};
+  int  max_bytes_per_msg{-1};
+  int  decode_workers{-1};
+  bool async_blit{false};
+  bool glyph_cache{false};
+  bool control_channel{false};
+  bool video_region{false};
+};
+
+// Sizes and placement derived at setup() from the configured budget and the heap actually present.
+// Everything the view allocates for streaming is charged against `budget`; `used` is the sum.
+struct MemoryPlan {
+  size_t budget{0};
+  size_t used{0};
+  size_t free_internal{0};
+  size_t free_psram{0};
+  size_t fixed_bytes{0};    // socket and decode task stacks plus the socket buffer, all internal
+  bool   fixed_fits{false};  // false: the fixed costs exceed the budget or internal RAM; nothing else is planned
+
+  int    decode_queue_depth{0};
+  size_t max_message_bytes{0};
+  size_t ws_buffer_size{0};
+  size_t msg_pool_slots{0};
+  bool   msg_pool_psram{false};
+  size_t strip_buffer_bytes{0};
+  int    video_slots{0};
+
+  bool   async_blit{false};
+  bool   glyph_cache{false};
+  size_t glyph_bytes{0};
+  bool   control_channel{false};
+  size_t ctl_buffer_size{0};
+
+  int decode_workers{1};
+  int ws_core{0};
+  int decode_core{0};
+  int decode_core_alt{0};  // second worker, if granted
+  int blit_core{0};
+  int ws_prio{0};
+  int ctl_prio{0};
+  int decode_prio{0};
+  int decode_prio_alt{0};
+  int blit_prio{0};
+  int ws_task_stack{0};
+  int ctl_task_stack{0};
+  int decode_task_stack{0};
+};
+
+// budget <= 0 means "auto": the fixed costs plus a quarter of PSRAM, or of internal RAM on boards
+// without it. An explicit budget also lets optional buffers use internal RAM down to
+// cfg::plan_internal_reserve.
+MemoryPlan plan_memory(const PlanRequest &req);
+
+}  // namespace remote_webview
+}  // namespace esphome
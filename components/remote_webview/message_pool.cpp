@@ -0,0 +1,53 @@
+#include "message_pool.h"
+
+#include "esp_heap_caps.h"
+
+#include <stdlib.h>
+
+namespace esphome {
+namespace remote_webview {
+
+bool MessagePool::init(size_t slots, size_t slot_size, bool psram) {
+  if (!slots || !slot_size) return false;
+
+  const uint32_t caps = psram ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : MALLOC_CAP_8BIT;
+  arena_ = (uint8_t *)heap_caps_malloc(slots * slot_size, caps);
+  if (!arena_) return false;
+
+  free_ = xQueueCreate(slots, sizeof(uint8_t *));
+  if (!free_) {
+    heap_caps_free(arena_);
+    arena_ = nullptr;
+    return false;
+  }
+
+  slots_ = slots;
+  slot_size_ = slot_size;
+  for (size_t i = 0; i < slots; i++) {
+    uint8_t *p = arena_ + i * slot_size;
+    xQueueSend(free_, &p, 0);
+  }
+  return true;
+}
+
+uint8_t *MessagePool::acquire(size_t len) {
+  uint8_t *p = nullptr;
+  if (free_ && len <= slot_size_ && xQueueReceive(free_, &p, 0) == pdTRUE)
+    return p;
+
+  p = (uint8_t *)heap_caps_malloc(len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!p) p = (uint8_t *)heap_caps_malloc(len, MALLOC_CAP_8BIT);
+  return p;
+}
+
+void MessagePool::release(uint8_t *p) {
+  if (!p) return;
+  if (owns_(p)) {
+    xQueueSend(free_, &p, 0);
+    return;
+  }
+  free(p);
+}
+
+}  // namespace remote_webview
+}  // namespace esphome
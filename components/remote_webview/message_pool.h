@@ -0,0 +1,32 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+namespace esphome {
+namespace remote_webview {
+
+// Fixed-size reassembly buffers carved from one allocation, so steady-state
+// streaming does not fragment the heap. Oversized or overflow requests fall back to malloc.
+class MessagePool {
+ public:
+  bool init(size_t slots, size_t slot_size, bool psram);
+  uint8_t *acquire(size_t len);
+  void release(uint8_t *p);
+
+  size_t slots() const { return slots_; }
+  size_t slot_size() const { return slot_size_; }
+
+ private:
+  bool owns_(const uint8_t *p) const { return arena_ && p >= arena_ && p < arena_ + slots_ * slot_size_; }
+
+  uint8_t *arena_{nullptr};
+  size_t slots_{0};
+  size_t slot_size_{0};
+  QueueHandle_t free_{nullptr};
+};
+
+}  // namespace remote_webview
+}  // namespace esphome
@@ -0,0 +1,42 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+namespace esphome {
+namespace remote_webview {
+
+// Native format of the panel, negotiated with the server as "pf" in the connect URI.
+enum class PixelFormat : uint8_t { RGB565 = 0, RGB332 = 1, GRAY8 = 2, GRAY4 = 3, MONO = 4 };
+
+inline const char *pixel_format_token(PixelFormat f) {
+  switch (f) {
+    case PixelFormat::RGB332: return "rgb332";
+    case PixelFormat::GRAY8:  return "gray8";
+    case PixelFormat::GRAY4:  return "gray4";
+    case PixelFormat::MONO:   return "mono";
+    default:                  return "rgb565";
+  }
+}
+
+inline bool pixel_format_is_gray(PixelFormat f) {
+  return f == PixelFormat::GRAY8 || f == PixelFormat::GRAY4 || f == PixelFormat::MONO;
+}
+
+// RRRRRGGG GGGBBBBB -> RRRGGGBB
+inline uint8_t rgb565_to_332(uint16_t c) {
+  return (uint8_t)(((c >> 8) & 0xE0) | ((c >> 6) & 0x1C) | ((c >> 3) & 0x03));
+}
+
+// Quantizes an 8-bit luma sample to the panel's levels; MONO uses a 4x4 ordered
+// dither so it can run per JPEG block without carrying error between blocks.
+inline uint8_t quantize_gray(PixelFormat f, uint8_t g, int x, int y) {
+  static constexpr uint8_t kBayer4[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+  switch (f) {
+    case PixelFormat::GRAY4: return (uint8_t)((g >> 4) * 17);
+    case PixelFormat::MONO:  return g > kBayer4[y & 3][x & 3] * 16 + 8 ? 255 : 0;
+    default:                 return g;
+  }
+}
+
+}  // namespace remote_webview
+}  // namespace esphome
@@ -8,9 +8,23 @@ namespace esphome::remote_webview::proto {
 constexpr uint8_t kProtocolVersion = 1;
 constexpr uint8_t kFlafLastOfFrame = 1u<<0;
 constexpr uint8_t kFlagIsFullFrame = 1u<<1;
+// bits 2..3: log2 of the upscale factor for reduced-resolution frames (sent during gestures)
+constexpr uint16_t kFrameScaleShift = 2;
+constexpr uint16_t kFrameScaleMask  = 3u<<kFrameScaleShift;
+// second pass of a progressive update: same frame_id as the preview it refines
+constexpr uint16_t kFlagIsRefinement = 1u<<4;
+// [capture_us:8] (server clock) follows the frame header
+constexpr uint16_t kFlagHasCaptureTime = 1u<<5;
+// [x:2][y:2][w:2][h:2] priority rect (e.g. the control being pressed) follows, after capture_us if present
+constexpr uint16_t kFlagHasPriorityRect = 1u<<6;
 
-enum class MsgType   : uint8_t { Unknown = 0, Frame = 1, Touch = 2, FrameStats = 3, OpenURL = 4, Keepalive = 5 };
-enum class Encoding  : uint8_t { Unknown = 0, PNG = 1, JPEG = 2, RAW565 = 3, RAW565_RLE = 4, RAW565_LZ4 = 5 };
+enum class MsgType   : uint8_t { Unknown = 0, Frame = 1, Touch = 2, FrameStats = 3, OpenURL = 4, Keepalive = 5, Pong = 6,
+                                 Pause = 7, Resume = 8, Calibration = 9, CalibrationResult = 10,
+                                 GlyphUpload = 11, Background = 12, TextRun = 13, VideoRegion = 14, VideoFrame = 15 };
+// Raw formats are row-major with rows padded to a whole byte; GRAY4 keeps the left pixel in
+// the high nibble and MONO1 the left pixel in the MSB (1 = white).
+enum class Encoding  : uint8_t { Unknown = 0, PNG = 1, JPEG = 2, RAW565 = 3, RAW565_RLE = 4, RAW565_LZ4 = 5,
+                                 RAW332 = 6, GRAY8 = 7, GRAY4 = 8, MONO1 = 9 };
 enum class TouchType : uint8_t { Unknown = 0, Down = 1, Move = 2, Up = 3 };
 
 #if defined(__GNUC__)
@@ -74,6 +88,106 @@ struct RWV_PACKED KeepalivePacket {
 };
 static_assert(sizeof(KeepalivePacket) == 2, "KeepalivePacket wire size must be 2");
 
+// [type:1][ver:1][client_us:8] => 10 bytes. Same type as the keepalive, only sent once lat=1
+// was negotiated; the server answers it with a Pong.
+struct RWV_PACKED PingPacket {
+  MsgType type;
+  uint8_t ver;
+  uint64_t client_us;
+};
+static_assert(sizeof(PingPacket) == 10, "PingPacket wire size must be 10");
+
+// [type:1][ver:1] => 2 bytes. Pause stops frame streaming; Resume restarts it with one full frame.
+// Resume while streaming just asks for that full frame (e.g. after calibration drew over the panel).
+struct RWV_PACKED StreamControlPacket {
+  MsgType type;
+  uint8_t ver;
+};
+static_assert(sizeof(StreamControlPacket) == 2, "StreamControlPacket wire size must be 2");
+
+// [type:1][ver:1][count:2] + count x ([tile_size:2][quality:1][dlen:4][jpeg...]) => 4 bytes + entries
+struct RWV_PACKED CalibrationHeader {
+  MsgType type;
+  uint8_t ver;
+  uint16_t count;
+};
+static_assert(sizeof(CalibrationHeader) == 4, "CalibrationHeader wire size must be 4");
+
+// [type:1][ver:1][tile_size:2][quality:1][min_frame_interval:2] => 7 bytes
+struct RWV_PACKED CalibrationResultPacket {
+  MsgType type;
+  uint8_t ver;
+  uint16_t tile_size;
+  uint8_t quality;
+  uint16_t min_frame_interval;
+};
+static_assert(sizeof(CalibrationResultPacket) == 7, "CalibrationResultPacket wire size must be 7");
+
+// [type:1][ver:1][count:2] + count x ([glyph_id:2][w:1][h:1][alpha:w*h]) => 4 bytes + entries
+struct RWV_PACKED GlyphUploadHeader {
+  MsgType type;
+  uint8_t ver;
+  uint16_t count;
+};
+static_assert(sizeof(GlyphUploadHeader) == 4, "GlyphUploadHeader wire size must be 4");
+
+// [type:1][ver:1][bg_id:1][x:2][y:2][w:2][h:2] + w*h RGB565 (LE) => 11 bytes + pixels
+struct RWV_PACKED BackgroundHeader {
+  MsgType type;
+  uint8_t ver;
+  uint8_t bg_id;
+  uint16_t x, y, w, h;
+};
+static_assert(sizeof(BackgroundHeader) == 11, "BackgroundHeader wire size must be 11");
+
+// [type:1][ver:1][x:2][y:2][w:2][h:2][bg_id:1][bg_color:2][count:2] + count x TextRunGlyph => 15 bytes + entries
+// bg_id kNoBackground composites over a solid bg_color.
+struct RWV_PACKED TextRunHeader {
+  MsgType type;
+  uint8_t ver;
+  uint16_t x, y, w, h;
+  uint8_t bg_id;
+  uint16_t bg_color;
+  uint16_t count;
+};
+static_assert(sizeof(TextRunHeader) == 15, "TextRunHeader wire size must be 15");
+
+// [glyph_id:2][dx:2][dy:2][color:2], dx/dy signed and relative to the run origin => 8 bytes
+struct RWV_PACKED TextRunGlyph {
+  uint16_t glyph_id;
+  int16_t dx, dy;
+  uint16_t color;
+};
+static_assert(sizeof(TextRunGlyph) == 8, "TextRunGlyph wire size must be 8");
+
+constexpr uint8_t kNoBackground = 0xFF;
+
+// [type:1][ver:1][x:2][y:2][w:2][h:2] => 10 bytes; w or h of 0 closes the region
+struct RWV_PACKED VideoRegionPacket {
+  MsgType type;
+  uint8_t ver;
+  uint16_t x, y, w, h;
+};
+static_assert(sizeof(VideoRegionPacket) == 10, "VideoRegionPacket wire size must be 10");
+
+// [type:1][ver:1][seq:4] + bare JPEG sized to the declared region => 6 bytes + jpeg
+struct RWV_PACKED VideoFrameHeader {
+  MsgType type;
+  uint8_t ver;
+  uint32_t seq;
+};
+static_assert(sizeof(VideoFrameHeader) == 6, "VideoFrameHeader wire size must be 6");
+
+// [type:1][ver:1][client_us:8][server_rx_us:8][server_tx_us:8] => 26 bytes
+struct RWV_PACKED PongPacket {
+  MsgType type;
+  uint8_t ver;
+  uint64_t client_us;
+  uint64_t server_rx_us;
+  uint64_t server_tx_us;
+};
+static_assert(sizeof(PongPacket) == 26, "PongPacket wire size must be 26");
+
 #if !defined(__GNUC__)
   #pragma pack(pop)
 #endif
@@ -81,61 +195,119 @@ static_assert(sizeof(KeepalivePacket) == 2, "KeepalivePacket wire size must be 2
 
 inline uint16_t rd16(const uint8_t *p){ return (uint16_t)p[0] | ((uint16_t)p[1] << 8); }
 inline uint32_t rd32(const uint8_t *p){ return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+inline uint64_t rd64(const uint8_t *p){ return (uint64_t)rd32(p) | ((uint64_t)rd32(p + 4) << 32); }
 inline void wr16(uint8_t *p, uint16_t v){ p[0]=(uint8_t)v; p[1]=(uint8_t)(v>>8); }
+inline void wr32(uint8_t *p, uint32_t v){ wr16(p, (uint16_t)v); wr16(p + 2, (uint16_t)(v>>16)); }
+inline void wr64(uint8_t *p, uint64_t v){ wr32(p, (uint32_t)v); wr32(p + 4, (uint32_t)(v>>32)); }
 
 struct FrameInfo {
   uint32_t frame_id;
   Encoding enc;
   uint16_t tile_count;
   uint16_t flags;
+  uint64_t capture_us;  // 0 unless kFlagHasCaptureTime
+  uint16_t prio_x, prio_y, prio_w, prio_h;  // all 0 unless kFlagHasPriorityRect
 };
 
-inline bool parse_frame_header(const uint8_t *data, size_t len, FrameInfo &out, size_t &off) {
-  if (len < sizeof(FrameHeader)) return false;
+struct PongInfo {
+  uint64_t client_us;
+  uint64_t server_rx_us;
+  uint64_t server_tx_us;
+};
 
-  FrameHeader h;
-  memcpy(&h, data, sizeof(h));
+inline uint8_t frame_scale_shift(uint16_t flags) { return (uint8_t)((flags & kFrameScaleMask) >> kFrameScaleShift); }
 
-  if (h.type != MsgType::Frame || h.version != kProtocolVersion) return false;
+inline bool parse_frame_header(const uint8_t *data, size_t len, FrameInfo &out, size_t &off) {
+  if (!data || len < sizeof(FrameHeader)) return false;
+  if ((MsgType)data[0] != MsgType::Frame || data[1] != kProtocolVersion) return false;
 
-  out.frame_id = rd32(reinterpret_cast<const uint8_t*>(&h.frame_id));
-  out.enc = h.encoding;
-  out.tile_count = rd16(reinterpret_cast<const uint8_t*>(&h.tile_count));
-  out.flags = rd16(reinterpret_cast<const uint8_t*>(&h.flags));
+  out.frame_id   = rd32(data + 2);
+  out.enc        = (Encoding)data[6];
+  out.tile_count = rd16(data + 7);
+  out.flags      = rd16(data + 9);
+  out.capture_us = 0;
+  out.prio_x = out.prio_y = out.prio_w = out.prio_h = 0;
   off = sizeof(FrameHeader);
-  
+
+  if (out.flags & kFlagHasCaptureTime) {
+    if (len < off + 8) return false;
+    out.capture_us = rd64(data + off);
+    off += 8;
+  }
+  if (out.flags & kFlagHasPriorityRect) {
+    if (len < off + 8) return false;
+    out.prio_x = rd16(data + off);
+    out.prio_y = rd16(data + off + 2);
+    out.prio_w = rd16(data + off + 4);
+    out.prio_h = rd16(data + off + 6);
+    off += 8;
+  }
+
   return true;
 }
 
-inline bool parse_tile_header(const uint8_t *buf, size_t len, TileHeader &out, size_t &off) {
-  if (!buf) return false;
-  if (off + sizeof(TileHeader) > len) return false;
+struct TileView {
+  uint16_t x, y, w, h;
+  uint32_t dlen;
+  const uint8_t *data;
+};
 
-  const uint8_t *th = buf + off;
-  out.x       = rd16(th + 0);
-  out.y       = rd16(th + 2);
-  out.w       = rd16(th + 4);
-  out.h       = rd16(th + 6);
-  out.dlen    = rd32(th + 8);
+// Zero-copy view over a Frame message. parse() checks the header and every tile
+// bound once; iterating afterwards does no further validation.
+class FrameView {
+ public:
+  class iterator {
+   public:
+    iterator(const uint8_t *p, uint16_t left) : p_(p), left_(left) {}
+    TileView operator*() const {
+      return TileView{rd16(p_), rd16(p_ + 2), rd16(p_ + 4), rd16(p_ + 6), rd32(p_ + 8), p_ + sizeof(TileHeader)};
+    }
+    iterator &operator++() {
+      p_ += sizeof(TileHeader) + rd32(p_ + 8);
+      left_--;
+      return *this;
+    }
+    bool operator!=(const iterator &o) const { return left_ != o.left_; }
 
-  off += sizeof(TileHeader);
-  return true;
-}
+   private:
+    const uint8_t *p_;
+    uint16_t left_;
+  };
+
+  bool parse(const uint8_t *data, size_t len) {
+    size_t off = 0;
+    if (!parse_frame_header(data, len, info_, off)) return false;
+
+    tiles_ = data + off;
+    for (uint16_t i = 0; i < info_.tile_count; i++) {
+      if (len - off < sizeof(TileHeader)) return false;
+      const uint32_t dlen = rd32(data + off + 8);
+      off += sizeof(TileHeader);
+      if (len - off < dlen) return false;
+      off += dlen;
+    }
+    return true;
+  }
+
+  const FrameInfo &info() const { return info_; }
+  iterator begin() const { return iterator(tiles_, info_.tile_count); }
+  iterator end() const { return iterator(nullptr, 0); }
+
+ private:
+  FrameInfo info_{};
+  const uint8_t *tiles_{nullptr};
+};
 
 inline size_t build_touch_packet(TouchType t, uint8_t pid, uint16_t x, uint16_t y, uint8_t *out) {
-  TouchPacket pkt{};
-  pkt.type = MsgType::Touch;
-  pkt.version = kProtocolVersion;
-  pkt.subtype = t;
-  pkt.pointer_id = pid;
-  
-  uint8_t *px = reinterpret_cast<uint8_t*>(&pkt.x);
-  uint8_t *py = reinterpret_cast<uint8_t*>(&pkt.y);
-  wr16(px, x);
-  wr16(py, y);
-  memcpy(out, &pkt, sizeof(pkt));
-  
-  return sizeof(pkt);
+  if (!out) return 0;
+
+  out[0] = (uint8_t)MsgType::Touch;
+  out[1] = kProtocolVersion;
+  out[2] = (uint8_t)t;
+  out[3] = pid;
+  wr16(out + 4, x);
+  wr16(out + 6, y);
+  return sizeof(TouchPacket);
 }
 
 inline size_t build_open_url_packet(const char *url, uint16_t flags, uint8_t *out, size_t out_cap) {
@@ -145,11 +317,10 @@ inline size_t build_open_url_packet(const char *url, uint16_t flags, uint8_t *ou
   const size_t total = sizeof(OpenURLHeader) + (size_t) n;
   if (total > out_cap) return 0;
 
-  auto *p = reinterpret_cast<OpenURLHeader *>(out);
-  p->type    = MsgType::OpenURL;
-  p->ver     = kProtocolVersion;
-  p->flags   = flags;
-  p->url_len = n;
+  out[0] = (uint8_t)MsgType::OpenURL;
+  out[1] = kProtocolVersion;
+  wr16(out + 2, flags);
+  wr32(out + 4, n);
 
   memcpy(out + sizeof(OpenURLHeader), url, n);
   return total;
@@ -158,23 +329,145 @@ inline size_t build_open_url_packet(const char *url, uint16_t flags, uint8_t *ou
 inline size_t build_frame_stats_packet(uint32_t avg_time, uint32_t bytes, uint8_t *out) {
   if (!out) return 0;
 
-  FrameStatsPacket pkt{};
-  pkt.type = MsgType::FrameStats;
-  pkt.ver = kProtocolVersion;
-  pkt.avg_time = avg_time;
-  pkt.bytes = bytes;
-
-  memcpy(out, &pkt, sizeof(pkt));
-  return sizeof(pkt);
+  out[0] = (uint8_t)MsgType::FrameStats;
+  out[1] = kProtocolVersion;
+  wr32(out + 2, avg_time);
+  wr32(out + 6, bytes);
+  return sizeof(FrameStatsPacket);
 }
 
 inline size_t build_keepalive_packet(uint8_t *out) {
   if (!out) return 0;
-  KeepalivePacket pkt{};
-  pkt.type = MsgType::Keepalive;
-  pkt.ver  = kProtocolVersion;
-  memcpy(out, &pkt, sizeof(pkt));
-  return sizeof(pkt);
+
+  out[0] = (uint8_t)MsgType::Keepalive;
+  out[1] = kProtocolVersion;
+  return sizeof(KeepalivePacket);
+}
+
+inline size_t build_ping_packet(uint64_t client_us, uint8_t *out) {
+  if (!out) return 0;
+
+  out[0] = (uint8_t)MsgType::Keepalive;
+  out[1] = kProtocolVersion;
+  wr64(out + 2, client_us);
+  return sizeof(PingPacket);
+}
+
+inline size_t build_stream_control_packet(bool pause, uint8_t *out) {
+  if (!out) return 0;
+
+  out[0] = (uint8_t)(pause ? MsgType::Pause : MsgType::Resume);
+  out[1] = kProtocolVersion;
+  return sizeof(StreamControlPacket);
+}
+
+struct CalibrationTile {
+  uint16_t tile_size;
+  uint8_t quality;
+  uint32_t dlen;
+  const uint8_t *data;
+};
+
+// Same contract as FrameView::parse: on success every entry lies within the message.
+inline bool parse_calibration_packet(const uint8_t *data, size_t len, CalibrationTile *out, size_t cap, size_t &count) {
+  if (!data || len < sizeof(CalibrationHeader)) return false;
+  if ((MsgType)data[0] != MsgType::Calibration || data[1] != kProtocolVersion) return false;
+
+  const uint16_t n = rd16(data + 2);
+  size_t off = sizeof(CalibrationHeader);
+  count = 0;
+  for (uint16_t i = 0; i < n; i++) {
+    if (len - off < 7) return false;
+    CalibrationTile t{rd16(data + off), data[off + 2], rd32(data + off + 3), nullptr};
+    off += 7;
+    if (len - off < t.dlen) return false;
+    t.data = data + off;
+    off += t.dlen;
+    if (count < cap) out[count++] = t;
+  }
+  return true;
+}
+
+struct BackgroundInfo {
+  uint8_t bg_id;
+  uint16_t x, y, w, h;
+  const uint8_t *pixels;  // w*h RGB565, little-endian
+};
+
+inline bool parse_background_packet(const uint8_t *data, size_t len, BackgroundInfo &out) {
+  if (!data || len < sizeof(BackgroundHeader)) return false;
+  if ((MsgType)data[0] != MsgType::Background || data[1] != kProtocolVersion) return false;
+
+  out.bg_id = data[2];
+  out.x = rd16(data + 3);
+  out.y = rd16(data + 5);
+  out.w = rd16(data + 7);
+  out.h = rd16(data + 9);
+  out.pixels = data + sizeof(BackgroundHeader);
+  return len - sizeof(BackgroundHeader) >= (size_t)out.w * out.h * 2u;
+}
+
+struct TextRunInfo {
+  uint16_t x, y, w, h;
+  uint8_t bg_id;
+  uint16_t bg_color;
+  uint16_t count;
+  const uint8_t *glyphs;  // count x TextRunGlyph
+};
+
+inline bool parse_text_run_packet(const uint8_t *data, size_t len, TextRunInfo &out) {
+  if (!data || len < sizeof(TextRunHeader)) return false;
+  if ((MsgType)data[0] != MsgType::TextRun || data[1] != kProtocolVersion) return false;
+
+  out.x = rd16(data + 2);
+  out.y = rd16(data + 4);
+  out.w = rd16(data + 6);
+  out.h = rd16(data + 8);
+  out.bg_id = data[10];
+  out.bg_color = rd16(data + 11);
+  out.count = rd16(data + 13);
+  out.glyphs = data + sizeof(TextRunHeader);
+  return len - sizeof(TextRunHeader) >= (size_t)out.count * sizeof(TextRunGlyph);
+}
+
+// Reads the frame size from the first SOFn marker without decoding anything.
+inline bool jpeg_dimensions(const uint8_t *data, size_t len, uint16_t &w, uint16_t &h) {
+  if (!data || len < 4 || data[0] != 0xFF || data[1] != 0xD8) return false;
+  size_t off = 2;
+  while (off + 4 <= len) {
+    if (data[off] != 0xFF) return false;
+    const uint8_t marker = data[off + 1];
+    const uint16_t seg = (uint16_t)((data[off + 2] << 8) | data[off + 3]);  // JPEG itself is big-endian
+    if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+      if (off + 9 > len) return false;
+      h = (uint16_t)((data[off + 5] << 8) | data[off + 6]);
+      w = (uint16_t)((data[off + 7] << 8) | data[off + 8]);
+      return true;
+    }
+    off += 2 + seg;
+  }
+  return false;
+}
+
+inline size_t build_calibration_result_packet(uint16_t tile_size, uint8_t quality, uint16_t mfi, uint8_t *out) {
+  if (!out) return 0;
+
+  out[0] = (uint8_t)MsgType::CalibrationResult;
+  out[1] = kProtocolVersion;
+  wr16(out + 2, tile_size);
+  out[4] = quality;
+  wr16(out + 5, mfi);
+  return sizeof(CalibrationResultPacket);
+}
+
+inline bool parse_pong_packet(const uint8_t *data, size_t len, PongInfo &out) {
+  if (!data || len < sizeof(PongPacket)) return false;
+  if ((MsgType)data[0] != MsgType::Pong || data[1] != kProtocolVersion) return false;
+
+  out.client_us    = rd64(data + 2);
+  out.server_rx_us = rd64(data + 10);
+  out.server_tx_us = rd64(data + 18);
+  return true;
 }
 
 } // namespace esphome::remote_webview::proto
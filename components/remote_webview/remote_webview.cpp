@@ -1,23 +1,29 @@
 #include "remote_webview.h"
 #include "remote_webview_config.h"
 #include "esphome/core/log.h"
+#include "esphome/core/helpers.h"
 
 #include "esp_idf_version.h"
 #include "esp_event.h"
-#include "esp_mac.h"
 #include "esp_system.h"
 #include "esp_timer.h"
 #include "esp_heap_caps.h"
 #include "esp_websocket_client.h"
-#include "esp_efuse.h"
+#if REMOTE_WEBVIEW_HOST
+  #include <unistd.h>
+#else
+  #include "esp_mac.h"
+  #include "esp_efuse.h"
+#endif
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+#include <algorithm>
+
 namespace esphome {
 namespace remote_webview {
 
 static const char *const TAG = "Remote_WebView";
-RemoteWebView *RemoteWebView::self_ = nullptr;
 
 static inline void websocket_force_reconnect(esp_websocket_client_handle_t client) {
   if (!client) return;
@@ -26,8 +32,6 @@ static inline void websocket_force_reconnect(esp_websocket_client_handle_t clien
 }
 
 void RemoteWebView::setup() {
-  self_ = this;
-
   if (!display_) {
     ESP_LOGE(TAG, "no display");
     return;
@@ -36,10 +40,122 @@ void RemoteWebView::setup() {
   display_width_ = display_->get_width();
   display_height_ = display_->get_height();
 
-  q_decode_ = xQueueCreate(cfg::decode_queue_depth, sizeof(WsMsg));
+  if (auto_calibrate_) {
+    cal_pref_ = global_preferences->make_preference<CalibrationResult>(
+        fnv1_hash("remote_webview_cal_" + server_host_ + "_" + resolve_device_id_() + "_" +
+                  std::to_string(display_width_) + "x" + std::to_string(display_height_)));
+    CalibrationResult saved{};
+    if (cal_pref_.load(&saved) && saved.version == cfg::calibration_version &&
+        saved.width == display_width_ && saved.height == display_height_) {
+      cal_ = saved;
+      calibrated_ = true;
+    }
+  }
+
+  if (glyph_cache_ && pixel_format_is_gray(pixel_format_)) {
+    ESP_LOGW(TAG, "glyph_cache needs an RGB pixel_format, disabling");
+    glyph_cache_ = false;
+  }
+  if (async_blit_ && pixel_format_is_gray(pixel_format_)) {
+    ESP_LOGW(TAG, "async_blit needs an RGB pixel_format, disabling");
+    async_blit_ = false;
+  }
+
+  PlanRequest req;
+  req.budget = memory_budget_;
+  req.max_bytes_per_msg = max_bytes_per_msg_;
+  req.decode_workers = decode_workers_;
+  req.async_blit = async_blit_;
+  req.glyph_cache = glyph_cache_;
+  req.control_channel = control_channel_;
+  req.video_region = video_region_;
+  plan_ = plan_memory(req);
+  if (!plan_.fixed_fits) {
+    ESP_LOGE(TAG, "socket and decode tasks need %u bytes of internal RAM; free %u (%u kept back), budget %u",
+             (unsigned)plan_.fixed_bytes, (unsigned)plan_.free_internal, (unsigned)cfg::plan_internal_reserve,
+             (unsigned)plan_.budget);
+    mark_failed();
+    return;
+  }
+
+  auto granted = [](bool &opt, bool plan, const char *name) {
+    if (opt && !plan) ESP_LOGW(TAG, "%s does not fit the memory budget, disabling", name);
+    opt = opt && plan;
+  };
+  granted(async_blit_, plan_.async_blit, "async_blit");
+  granted(glyph_cache_, plan_.glyph_cache, "glyph_cache");
+  granted(control_channel_, plan_.control_channel, "control_channel");
+
+  if (plan_.msg_pool_slots && !pool_.init(plan_.msg_pool_slots, plan_.max_message_bytes, plan_.msg_pool_psram)) {
+    ESP_LOGW(TAG, "message pool (%u x %u) unavailable, using malloc",
+             (unsigned)plan_.msg_pool_slots, (unsigned)plan_.max_message_bytes);
+  }
+
+  if (pixel_format_ != PixelFormat::RGB565 && gesture_scale_ > 1) {
+    ESP_LOGW(TAG, "gesture_scale needs pixel_format RGB565, disabling");
+    gesture_scale_ = -1;
+  }
+  if (pixel_format_ == PixelFormat::RGB332) {
+    convert_buf_ = (uint8_t *)heap_caps_malloc(cfg::convert_buf_px, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!convert_buf_) convert_buf_ = (uint8_t *)heap_caps_malloc(cfg::convert_buf_px, MALLOC_CAP_8BIT);
+    if (!convert_buf_) {
+      // the format is negotiated in the connect URI built later, so falling back is still clean here
+      ESP_LOGW(TAG, "malloc %u for RGB332 conversion failed, falling back to RGB565", (unsigned)cfg::convert_buf_px);
+      pixel_format_ = PixelFormat::RGB565;
+    }
+  }
+
+  if (glyph_cache_ && !glyphs_.init(cfg::glyph_atlas_bytes, cfg::glyph_max, cfg::glyph_bg_bytes, cfg::glyph_bg_slots,
+                                    cfg::glyph_run_max_px)) {
+    ESP_LOGW(TAG, "glyph cache needs %u KB of PSRAM, disabling",
+             (unsigned)((cfg::glyph_atlas_bytes + cfg::glyph_bg_bytes + cfg::glyph_run_max_px * 2u) / 1024));
+    glyph_cache_ = false;
+  }
+
+  if (async_blit_) {
+    if (!blit_.start(display_, plan_.strip_buffer_bytes / BlitStage::kStrips, plan_.blit_core, plan_.blit_prio)) {
+      ESP_LOGW(TAG, "async blit unavailable, drawing synchronously");
+      async_blit_ = false;
+    }
+  }
+
+  // one output row of the widest tile, repeated for every upscaled line
+  while (gesture_scale_ > 1 && (size_t)display_width_ * (size_t)gesture_scale_ * 2u > plan_.strip_buffer_bytes)
+    gesture_scale_ /= 2;
+  if (gesture_scale_ > 1) {
+    scale_buf_px_ = (size_t)display_width_ * (size_t)gesture_scale_;
+    scale_buf_ = (uint16_t *)heap_caps_malloc(scale_buf_px_ * 2u, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!scale_buf_) scale_buf_ = (uint16_t *)heap_caps_malloc(scale_buf_px_ * 2u, MALLOC_CAP_8BIT);
+    if (!scale_buf_) {
+      ESP_LOGE(TAG, "malloc %u for upscale buffer failed", (unsigned)(scale_buf_px_ * 2u));
+      scale_buf_px_ = 0;
+      gesture_scale_ = -1;
+    }
+  }
+
+  if (preview_quality_ > 0) {
+    region_cols_ = (display_width_  + cfg::refine_cell_px - 1) / cfg::refine_cell_px;
+    region_rows_ = (display_height_ + cfg::refine_cell_px - 1) / cfg::refine_cell_px;
+    const size_t n = (size_t)region_cols_ * (size_t)region_rows_;
+    region_frame_ = (uint32_t *)heap_caps_malloc(n * sizeof(uint32_t), MALLOC_CAP_8BIT);
+    if (!region_frame_) {
+      ESP_LOGE(TAG, "malloc %u for refinement grid failed", (unsigned)(n * sizeof(uint32_t)));
+      region_cols_ = region_rows_ = 0;
+    }
+  }
+
+  q_decode_ = xQueueCreate(plan_.decode_queue_depth, sizeof(WsMsg));
+  q_ctl_ = xQueueCreate(cfg::ctl_queue_depth, sizeof(CtlMsg));
+  if (video_region_) q_video_ = xQueueCreate(plan_.video_slots, sizeof(WsMsg));
   ws_send_mtx_ = xSemaphoreCreateMutex();
+  if (control_channel_) ctl_send_mtx_ = xSemaphoreCreateMutex();
 
-  start_decode_task_();
+  decode_worker_ = DecodePool::instance().attach(this, plan_, plan_.decode_workers);
+  if (decode_worker_ < 0) {
+    ESP_LOGE(TAG, "no decode worker available");
+    mark_failed();
+    return;
+  }
   start_ws_task_();
 
   if (touch_) {
@@ -86,6 +202,14 @@ void RemoteWebView::setup() {
 #endif
 }
 
+void RemoteWebView::loop() {
+  if (cal_save_pending_) {
+    cal_save_pending_ = false;
+    cal_pref_.save(&cal_);
+    global_preferences->sync();
+  }
+}
+
 void RemoteWebView::dump_config() {
   ESP_LOGCONFIG(TAG, "remote_webview:");
 
@@ -122,14 +246,44 @@ void RemoteWebView::dump_config() {
   print_opt_int   ("max_bytes_per_msg",         max_bytes_per_msg_);
   print_opt_int   ("big_endian",                rgb565_big_endian_);
   print_opt_int   ("rotation",                  rotation_);
+  ESP_LOGCONFIG(TAG, "  pixel_format: %s", pixel_format_token(pixel_format_));
+  ESP_LOGCONFIG(TAG, "  async_blit: %s", blit_.running() ? "yes" : "no");
+  ESP_LOGCONFIG(TAG, "  control_channel: %s", control_channel_ ? "yes" : "no");
+  ESP_LOGCONFIG(TAG, "  touch_priority: %s", touch_priority_ ? "yes" : "no");
+  ESP_LOGCONFIG(TAG, "  glyph_cache: %s", glyph_cache_ ? "yes" : "no");
+  ESP_LOGCONFIG(TAG, "  video_region: %s", video_region_ ? "yes" : "no");
+  if (auto_calibrate_) {
+    if (calibrated_)
+      ESP_LOGCONFIG(TAG, "  calibration: tile_size=%u quality=%u min_frame_interval=%u", (unsigned)cal_.tile_size,
+                    (unsigned)cal_.quality, (unsigned)cal_.min_frame_interval);
+    else
+      ESP_LOGCONFIG(TAG, "  calibration: pending");
+  }
+  print_opt_int   ("gesture_scale",             gesture_scale_);
+  print_opt_int   ("preview_quality",           preview_quality_);
+  print_opt_int   ("latency_stats",             latency_stats_);
+
+  ESP_LOGCONFIG(TAG, "  memory plan:");
+  ESP_LOGCONFIG(TAG, "    free: internal=%u psram=%u, budget=%u (planned %u)", (unsigned)plan_.free_internal,
+                (unsigned)plan_.free_psram, (unsigned)plan_.budget, (unsigned)plan_.used);
+  ESP_LOGCONFIG(TAG, "    decode queue: %d, max message: %u", plan_.decode_queue_depth, (unsigned)plan_.max_message_bytes);
+  ESP_LOGCONFIG(TAG, "    message pool: %u slots in %s%s", (unsigned)pool_.slots(), plan_.msg_pool_psram ? "psram" : "internal",
+                pool_.slots() ? "" : " (malloc)");
+  ESP_LOGCONFIG(TAG, "    ws buffer: %u, strip buffer: %u", (unsigned)plan_.ws_buffer_size, (unsigned)plan_.strip_buffer_bytes);
+  ESP_LOGCONFIG(TAG, "    ws task: core %d prio %d stack %d", plan_.ws_core, plan_.ws_prio, plan_.ws_task_stack);
+  if (control_channel_)
+    ESP_LOGCONFIG(TAG, "    control task: prio %d stack %d buffer %u", plan_.ctl_prio, plan_.ctl_task_stack,
+                  (unsigned)plan_.ctl_buffer_size);
+  if (async_blit_) ESP_LOGCONFIG(TAG, "    blit task: core %d prio %d", plan_.blit_core, plan_.blit_prio);
+  if (glyph_cache_) ESP_LOGCONFIG(TAG, "    glyph cache: %u KB psram", (unsigned)(plan_.glyph_bytes / 1024));
+  if (video_region_) ESP_LOGCONFIG(TAG, "    video queue: %d", plan_.video_slots);
+  ESP_LOGCONFIG(TAG, "    decode worker: %d of %d (core %d prio %d stack %d)", decode_worker_,
+                DecodePool::instance().workers(), plan_.decode_core, plan_.decode_prio, plan_.decode_task_stack);
 }
 
 bool RemoteWebView::open_url(const std::string &s) {
   if (s.empty()) return false;
   
-  if (!ws_client_ || !esp_websocket_client_is_connected(ws_client_))
-    return false;
-  
   if (ws_send_open_url_(s.c_str(), 0)) {
     url_ = s;
     ESP_LOGD(TAG, "opened URL: %s", s.c_str());
@@ -139,8 +293,23 @@ bool RemoteWebView::open_url(const std::string &s) {
   return false;
 }
 
+void RemoteWebView::pause() {
+  if (paused_) return;
+  paused_ = true;
+  ws_send_stream_control_(true);
+  ESP_LOGD(TAG, "streaming paused");
+}
+
+void RemoteWebView::resume() {
+  if (!paused_) return;
+  paused_ = false;
+  ws_send_stream_control_(false);
+  ESP_LOGD(TAG, "streaming resumed");
+}
+
 void RemoteWebView::start_ws_task_() {
-  xTaskCreatePinnedToCore(&RemoteWebView::ws_task_tramp_, "rwv_ws", cfg::ws_task_stack, this, 5, &t_ws_, 0);
+  xTaskCreatePinnedToCore(&RemoteWebView::ws_task_tramp_, "rwv_ws", plan_.ws_task_stack, this, plan_.ws_prio, &t_ws_,
+                          plan_.ws_core);
 }
 
 void RemoteWebView::ws_task_tramp_(void *arg) {
@@ -151,77 +320,233 @@ void RemoteWebView::ws_task_tramp_(void *arg) {
   cfg_ws.uri = uri_str.c_str();
   cfg_ws.reconnect_timeout_ms = 2000;
   cfg_ws.network_timeout_ms   = 10000;
-  cfg_ws.task_stack           = cfg::ws_task_stack;
-  cfg_ws.task_prio            = cfg::ws_task_prio;
-  cfg_ws.buffer_size          = cfg::ws_buffer_size;
+  cfg_ws.task_stack           = self->plan_.ws_task_stack;
+  cfg_ws.task_prio            = self->plan_.ws_prio;
+  cfg_ws.buffer_size          = self->plan_.ws_buffer_size;
   cfg_ws.disable_auto_reconnect = false;
 
-  WsReasm reasm{};
   esp_websocket_client_handle_t client = esp_websocket_client_init(&cfg_ws);
-  ESP_ERROR_CHECK(esp_websocket_register_events(client, WEBSOCKET_EVENT_ANY, ws_event_handler_, &reasm));
+  ESP_ERROR_CHECK(esp_websocket_register_events(client, WEBSOCKET_EVENT_ANY, ws_event_handler_, self));
   ESP_ERROR_CHECK(esp_websocket_client_start(client));
 
+  esp_websocket_client_handle_t ctl = nullptr;
+  std::string ctl_uri_str;
+  if (self->control_channel_) {
+    ctl_uri_str = self->build_ctl_uri_();
+    esp_websocket_client_config_t cfg_ctl = cfg_ws;
+    cfg_ctl.uri         = ctl_uri_str.c_str();
+    cfg_ctl.task_stack  = self->plan_.ctl_task_stack;
+    cfg_ctl.task_prio   = self->plan_.ctl_prio;
+    cfg_ctl.buffer_size = self->plan_.ctl_buffer_size;
+
+    ctl = esp_websocket_client_init(&cfg_ctl);
+    ESP_ERROR_CHECK(esp_websocket_register_events(ctl, WEBSOCKET_EVENT_ANY, ctl_event_handler_, self));
+    ESP_ERROR_CHECK(esp_websocket_client_start(ctl));
+  }
+
   for (;;) {
     vTaskDelay(pdMS_TO_TICKS(5000));
 
+    if (esp_timer_get_time() - self->last_counters_log_us_ >= cfg::counters_log_interval_us) {
+      self->last_counters_log_us_ = esp_timer_get_time();
+      self->log_counters_();
+    }
+
+    if (self->uri_dirty_) {
+      // takes effect on the next (re)connect; the live session already got the result packet
+      self->uri_dirty_ = false;
+      uri_str = self->build_ws_uri_();
+      esp_websocket_client_set_uri(client, uri_str.c_str());
+    }
+
+    if (ctl && !esp_websocket_client_is_connected(ctl))
+      websocket_force_reconnect(ctl);
+
     if (!esp_websocket_client_is_connected(client)) {
       websocket_force_reconnect(client);
       continue;
     }
 
-    if (self && self->ws_client_ && esp_websocket_client_is_connected(self->ws_client_)) {
-      const uint64_t now = esp_timer_get_time();
-      if (now - self->last_keepalive_us_ >= cfg::ws_keepalive_interval_us) {
-        if (self->ws_send_keepalive_()) {
-          self->last_keepalive_us_ = now;
-          ESP_LOGV(TAG, "[ws] keepalive sent");
-        }
+    const uint64_t now = esp_timer_get_time();
+    const uint64_t interval = self->latency_stats_ ? cfg::ws_ping_interval_us : cfg::ws_keepalive_interval_us;
+    if (now - self->last_keepalive_us_ >= interval) {
+      if (self->ws_send_keepalive_()) {
+        self->last_keepalive_us_ = now;
+        ESP_LOGV(TAG, "[ws] keepalive sent");
       }
     }
   }
 }
 
+void RemoteWebView::log_counters_() {
+  const StreamCounters &c = counters_;
+  ESP_LOGD(TAG, "[stats] msgs=%u bytes=%llu reconnects=%u queue_peak=%u/%d",
+           (unsigned)c.messages, (unsigned long long)c.bytes, (unsigned)c.reconnects,
+           (unsigned)c.queue_peak, plan_.decode_queue_depth);
+  ESP_LOGD(TAG, "[stats] dropped: queue_full=%u oversize=%u alloc=%u bad_fragment=%u",
+           (unsigned)c.dropped_queue_full, (unsigned)c.dropped_oversize, (unsigned)c.alloc_failed,
+           (unsigned)c.bad_fragments);
+  ESP_LOGD(TAG, "[stats] heap: internal=%u (min %u) psram=%u (min %u)",
+           (unsigned)heap_caps_get_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),
+           (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT),
+           (unsigned)heap_caps_get_free_size(MALLOC_CAP_SPIRAM),
+           (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_SPIRAM));
+}
+
 void RemoteWebView::reasm_reset_(WsReasm &r) {
-  if (r.buf) free(r.buf);
+  if (r.buf) pool_.release(r.buf);
   r.buf = nullptr; r.total = 0; r.filled = 0;
 }
 
 void RemoteWebView::ws_event_handler_(void *handler_arg, esp_event_base_t, int32_t event_id, void *event_data) {
-  auto *r = reinterpret_cast<WsReasm*>(handler_arg);
-  auto *e = reinterpret_cast<const esp_websocket_event_data_t *>(event_data);
+  auto *self = reinterpret_cast<RemoteWebView*>(handler_arg);
+  self->on_ws_event_(event_id, reinterpret_cast<const esp_websocket_event_data_t *>(event_data));
+}
+
+void RemoteWebView::ctl_event_handler_(void *handler_arg, esp_event_base_t, int32_t event_id, void *event_data) {
+  auto *self = reinterpret_cast<RemoteWebView*>(handler_arg);
+  self->on_ctl_event_(event_id, reinterpret_cast<const esp_websocket_event_data_t *>(event_data));
+}
 
+void RemoteWebView::on_ctl_event_(int32_t event_id, const esp_websocket_event_data_t *e) {
   switch (event_id) {
     case WEBSOCKET_EVENT_CONNECTED:
-      if (self_) self_->ws_client_ = e->client;
+      ctl_client_ = e->client;
+      ESP_LOGI(TAG, "[ws] control channel connected");
+      // the server keeps one session per id; flow-control state goes on whichever socket is up
+      clock_resync_ = true;
+      if (paused_) ws_send_stream_control_(true);
+      break;
+
+    case WEBSOCKET_EVENT_DISCONNECTED:
+#ifdef WEBSOCKET_EVENT_CLOSED
+    case WEBSOCKET_EVENT_CLOSED:
+#endif
+      ctl_client_ = nullptr;
+      ESP_LOGI(TAG, "[ws] control channel down, falling back to the frame stream");
+      websocket_force_reconnect(e->client);
+      break;
+
+    case WEBSOCKET_EVENT_DATA: {
+      // control messages are tiny: anything fragmented or oversized is not ours
+      if (e->op_code != WS_TRANSPORT_OPCODES_BINARY) break;
+      if (e->payload_offset != 0 || e->data_len <= 0 || e->data_len != e->payload_len ||
+          (size_t)e->data_len > plan_.ctl_buffer_size) {
+        counters_.bad_fragments++;
+        break;
+      }
+      if (enqueue_control_((const uint8_t *)e->data_ptr, (size_t)e->data_len)) break;
+      uint8_t *buf = pool_.acquire((size_t)e->data_len);
+      if (!buf) { counters_.alloc_failed++; break; }
+      memcpy(buf, e->data_ptr, (size_t)e->data_len);
+      enqueue_message_(buf, (size_t)e->data_len, e->client);
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+// Small messages that must not wait behind decoding skip the pool and the frame queue.
+bool RemoteWebView::enqueue_control_(const uint8_t *data, size_t len) {
+  if (!q_ctl_ || !len || len > cfg::ctl_msg_max) return false;
+  const proto::MsgType type = (proto::MsgType)data[0];
+  if (type != proto::MsgType::Pong && type != proto::MsgType::FrameStats) return false;
+
+  CtlMsg c;
+  c.rx_us = esp_timer_get_time();
+  c.len = (uint8_t)len;
+  memcpy(c.data, data, len);
+  counters_.messages++;
+  counters_.bytes += len;
+  if (xQueueSend(q_ctl_, &c, 0) != pdTRUE) {
+    counters_.dropped_queue_full++;
+    return true;
+  }
+  DecodePool::instance().notify(decode_worker_);
+  return true;
+}
+
+void RemoteWebView::enqueue_message_(uint8_t *buf, size_t len, void *client) {
+  WsMsg m;
+  m.buf = buf; m.len = len; m.client = client; m.rx_us = esp_timer_get_time();
+  counters_.messages++;
+  counters_.bytes += m.len;
+  if (!q_decode_ || xQueueSend(q_decode_, &m, 0) != pdTRUE) {
+    ESP_LOGW(TAG, "decode queue full, dropping packet");
+    counters_.dropped_queue_full++;
+    pool_.release(m.buf);
+  } else {
+    const uint32_t waiting = (uint32_t)uxQueueMessagesWaiting(q_decode_);
+    if (waiting > counters_.queue_peak) counters_.queue_peak = waiting;
+    DecodePool::instance().notify(decode_worker_);
+  }
+}
+
+// Drop-oldest: a video frame waiting behind a newer one is never worth decoding.
+void RemoteWebView::enqueue_video_(uint8_t *buf, size_t len) {
+  WsMsg m;
+  m.buf = buf; m.len = len; m.rx_us = esp_timer_get_time();
+  counters_.messages++;
+  counters_.bytes += m.len;
+
+  if (xQueueSend(q_video_, &m, 0) != pdTRUE) {
+    WsMsg old;
+    if (xQueueReceive(q_video_, &old, 0) == pdTRUE) {
+      pool_.release(old.buf);
+      video_stats_.superseded++;
+    }
+    if (xQueueSend(q_video_, &m, 0) != pdTRUE) {
+      pool_.release(m.buf);
+      video_stats_.superseded++;
+      return;
+    }
+  }
+  DecodePool::instance().notify(decode_worker_);
+}
+
+void RemoteWebView::on_ws_event_(int32_t event_id, const esp_websocket_event_data_t *e) {
+  WsReasm *r = &reasm_;
+
+  switch (event_id) {
+    case WEBSOCKET_EVENT_CONNECTED:
+      ws_client_ = e->client;
       ESP_LOGI(TAG, "[ws] connected");
-      
-      if (self_) self_->last_keepalive_us_ = esp_timer_get_time();
-      if (self_ && !self_->url_.empty()) {
-        self_->ws_send_open_url_(self_->url_.c_str(), 0);
+      counters_.reconnects++;
+
+      last_keepalive_us_ = esp_timer_get_time();
+      region_synced_ = false;
+      clock_resync_ = true;
+      glyph_reset_ = true;
+      video_reset_ = true;
+      if (!url_.empty()) {
+        ws_send_open_url_(url_.c_str(), 0);
+      }
+      if (paused_) {
+        ws_send_stream_control_(true);
       }
       break;
 
     case WEBSOCKET_EVENT_DISCONNECTED:
-      if (self_) self_->ws_client_ = nullptr;
+      ws_client_ = nullptr;
       ESP_LOGI(TAG, "[ws] disconnected");
-      if (self_) self_->last_keepalive_us_ = 0; 
+      last_keepalive_us_ = 0;
       reasm_reset_(*r);
       websocket_force_reconnect(e->client);
       break;
 
 #ifdef WEBSOCKET_EVENT_CLOSED
     case WEBSOCKET_EVENT_CLOSED:
-      if (self_) self_->ws_client_ = nullptr;
+      ws_client_ = nullptr;
       ESP_LOGI(TAG, "[ws] closed");
-      if (self_) self_->last_keepalive_us_ = 0; 
+      last_keepalive_us_ = 0;
       reasm_reset_(*r);
       websocket_force_reconnect(e->client);
       break;
 #endif
 
     case WEBSOCKET_EVENT_DATA: {
-      if (!self_) break;
-
       const uint8_t *frag = (const uint8_t *)e->data_ptr;
       size_t frag_len = (size_t)e->data_len;
       bool is_bin  = (e->op_code == WS_TRANSPORT_OPCODES_BINARY);
@@ -229,22 +554,25 @@ void RemoteWebView::ws_event_handler_(void *handler_arg, esp_event_base_t, int32
 
       if (e->payload_offset == 0) {
         reasm_reset_(*r);
-        const size_t max_allowed = (self_ && self_->max_bytes_per_msg_ > 0) 
-                                   ? (size_t)self_->max_bytes_per_msg_ 
-                                   : cfg::ws_max_message_bytes;
+        // frames still in flight when pause() was sent are dropped before reassembly
+        if (paused_ && frag_len &&
+            ((proto::MsgType)frag[0] == proto::MsgType::Frame || (proto::MsgType)frag[0] == proto::MsgType::VideoFrame))
+          break;
+        const size_t max_allowed = plan_.max_message_bytes;
         if ((size_t)e->payload_len > max_allowed) {
           ESP_LOGE(TAG, "WS message too large: %u > %u", (unsigned)e->payload_len, (unsigned)max_allowed);
+          counters_.dropped_oversize++;
           break;
         }
         r->total = (size_t)e->payload_len;
-        r->buf   = (uint8_t *)heap_caps_malloc(r->total, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-        if (!r->buf) r->buf = (uint8_t *)heap_caps_malloc(r->total, MALLOC_CAP_8BIT);
-        if (!r->buf) { ESP_LOGE(TAG, "malloc %u failed", (unsigned)r->total); r->total = 0; break; }
+        r->buf   = pool_.acquire(r->total);
+        if (!r->buf) { ESP_LOGE(TAG, "malloc %u failed", (unsigned)r->total); r->total = 0; counters_.alloc_failed++; break; }
       }
       if (!r->buf || r->total == 0) break;
 
       if ((size_t)e->payload_offset + frag_len > r->total) {
         ESP_LOGE(TAG, "bad fragment bounds");
+        counters_.bad_fragments++;
         reasm_reset_(*r);
         break;
       }
@@ -253,13 +581,15 @@ void RemoteWebView::ws_event_handler_(void *handler_arg, esp_event_base_t, int32
       if (new_filled > r->filled) r->filled = new_filled;
 
       if (r->filled == r->total) {
-        WsMsg m;
-        m.buf = r->buf; m.len = r->total; m.client = e->client;
+        uint8_t *buf = r->buf;
+        const size_t len = r->total;
         r->buf = nullptr; r->total = 0; r->filled = 0;
-        if (!self_->q_decode_ || xQueueSend(self_->q_decode_, &m, 0) != pdTRUE) {
-          ESP_LOGW(TAG, "decode queue full, dropping packet");
-          free(m.buf);
-        }
+        if (q_video_ && len > sizeof(proto::VideoFrameHeader) && (proto::MsgType)buf[0] == proto::MsgType::VideoFrame)
+          enqueue_video_(buf, len);
+        else if (enqueue_control_(buf, len))
+          pool_.release(buf);
+        else
+          enqueue_message_(buf, len, e->client);
       }
       break;
     }
@@ -275,22 +605,30 @@ void RemoteWebView::ws_event_handler_(void *handler_arg, esp_event_base_t, int32
   }
 }
 
-void RemoteWebView::start_decode_task_() {
-  xTaskCreatePinnedToCore(&RemoteWebView::decode_task_tramp_, "rwv_decode", cfg::decode_task_stack, this, 6, &t_decode_, 1);
-}
+bool RemoteWebView::decode_next_() {
+  CtlMsg c;
+  if (q_ctl_ && xQueueReceive(q_ctl_, &c, 0) == pdTRUE) {
+    process_packet_(nullptr, c.data, c.len, c.rx_us);
+    return true;
+  }
 
-void RemoteWebView::decode_task_tramp_(void *arg) {
-  auto *self = reinterpret_cast<RemoteWebView*>(arg);
   WsMsg m;
-  for (;;) {
-    if (xQueueReceive(self->q_decode_, &m, portMAX_DELAY) == pdTRUE) {
-      self->process_packet_(m.client, m.buf, m.len);
-      free(m.buf);
-    }
+  if (q_decode_ && xQueueReceive(q_decode_, &m, 0) == pdTRUE) {
+    process_packet_(m.client, m.buf, m.len, m.rx_us);
+    pool_.release(m.buf);
+    return true;
   }
+
+  // video only gets the decoder when the UI queue is empty
+  if (q_video_ && xQueueReceive(q_video_, &m, 0) == pdTRUE) {
+    process_video_frame_(m);
+    pool_.release(m.buf);
+    return true;
+  }
+  return false;
 }
 
-void RemoteWebView::process_packet_(void * /*client*/, const uint8_t *data, size_t len) {
+void RemoteWebView::process_packet_(void * /*client*/, const uint8_t *data, size_t len, uint64_t rx_us) {
   if (!data || len == 0) return;
 
   const proto::MsgType type = (proto::MsgType)data[0];
@@ -301,6 +639,20 @@ void RemoteWebView::process_packet_(void * /*client*/, const uint8_t *data, size
     case proto::MsgType::FrameStats:
       process_frame_stats_packet_(data, len);
       break;
+    case proto::MsgType::Pong:
+      process_pong_packet_(data, len, rx_us);
+      break;
+    case proto::MsgType::Calibration:
+      process_calibration_packet_(data, len);
+      break;
+    case proto::MsgType::VideoRegion:
+      process_video_region_packet_(data, len);
+      break;
+    case proto::MsgType::GlyphUpload:
+    case proto::MsgType::Background:
+    case proto::MsgType::TextRun:
+      process_glyph_packet_(data, len);
+      break;
     default:
       ESP_LOGW(TAG, "unknown packet type: %d", (int)type);
       break;
@@ -309,45 +661,391 @@ void RemoteWebView::process_packet_(void * /*client*/, const uint8_t *data, size
 
 void RemoteWebView::process_frame_packet_(const uint8_t *data, size_t len)
 {
-  if (!data || len < sizeof(proto::FrameHeader)) return;
+  if (paused_) return;
 
-  proto::FrameInfo fi{};
-  size_t off = 0;
-  if (!proto::parse_frame_header(data, len, fi, off)) return;
+  proto::FrameView fv;
+  if (!fv.parse(data, len)) {
+    ESP_LOGW(TAG, "malformed frame message (%u bytes), dropping", (unsigned)len);
+    return;
+  }
+  const proto::FrameInfo &fi = fv.info();
+  const bool refinement = (fi.flags & proto::kFlagIsRefinement) != 0;
 
-  if (fi.frame_id != frame_id_) {
+  // a refinement reuses the preview's frame_id but is timed as its own pass
+  if (fi.frame_id != frame_id_ || refinement != frame_refinement_) {
     frame_id_ = fi.frame_id;
+    frame_refinement_ = refinement;
     frame_tiles_= 0;
     frame_bytes_= 0;
     frame_start_us_ = esp_timer_get_time();
+    frame_capture_us_ = fi.capture_us;
   }
   frame_bytes_ += len;
   frame_tiles_ += fi.tile_count;
 
-  for (uint16_t i = 0; i < fi.tile_count; i++) {
-    proto::TileHeader th{};
-    if (!proto::parse_tile_header(data, len, th, off)) return;
-    if (off + th.dlen > len) return;
+  if (region_frame_ && !refinement && !region_synced_) {
+    // frame ids restart with the server session, so only compare within one connection
+    const size_t n = (size_t)region_cols_ * (size_t)region_rows_;
+    for (size_t i = 0; i < n; i++) region_frame_[i] = fi.frame_id;
+    region_synced_ = true;
+  }
 
-    if (th.w == 0 || th.h == 0 || th.w > display_width_ || th.h > display_height_) {
-      off += th.dlen;
-      continue;
+  const uint8_t shift = proto::frame_scale_shift(fi.flags);
+  if (shift && (gesture_scale_ < (1 << shift) || !scale_buf_)) {
+    ESP_LOGW(TAG, "frame %u: scale 1/%d was not negotiated, dropping", (unsigned)fi.frame_id, 1 << shift);
+    return;
+  }
+
+  auto draw_tile = [&](const proto::TileView &t) {
+    if (t.w == 0 || t.h == 0 || t.w > display_width_ || t.h > display_height_)
+      return;
+
+    if (refinement && region_superseded_(t, fi.frame_id))
+      return;
+    if (!refinement) region_mark_(t, fi.frame_id);
+
+    if (fi.enc == proto::Encoding::JPEG && t.dlen) {
+      decode_jpeg_tile_to_lcd_((int16_t)t.x, (int16_t)t.y, t.w, t.data, t.dlen, shift);
+    } else if (t.dlen && !shift) {
+      draw_raw_tile_(fi.enc, t);
     }
+  };
+
+  // Tiles hitting the priority rect go first. A tile is only hoisted if no earlier tile it
+  // would jump over overlaps it, so the final screen matches wire order exactly.
+  uint32_t hoisted[cfg::priority_max_tiles / 32]{};
+  int px0, py0, px1, py1;
+  if (fi.tile_count > 1 && priority_rect_(fi, px0, py0, px1, py1)) {
+    auto overlaps = [](const proto::TileView &a, int x0, int y0, int x1, int y1) {
+      return a.x < x1 && x0 < a.x + a.w && a.y < y1 && y0 < a.y + a.h;
+    };
+    size_t i = 0;
+    for (auto it = fv.begin(); it != fv.end() && i < cfg::priority_max_tiles; ++it, ++i) {
+      const proto::TileView t = *it;
+      if (!overlaps(t, px0, py0, px1, py1)) continue;
+
+      bool blocked = false;
+      size_t j = 0;
+      for (auto jt = fv.begin(); j < i; ++jt, ++j) {
+        if (hoisted[j / 32] & (1u << (j % 32))) continue;
+        const proto::TileView e = *jt;
+        if (overlaps(e, t.x, t.y, t.x + t.w, t.y + t.h)) { blocked = true; break; }
+      }
+      if (blocked) continue;
 
-    if (fi.enc == proto::Encoding::JPEG && th.dlen) {
-      decode_jpeg_tile_to_lcd_((int16_t)th.x, (int16_t)th.y, data + off, th.dlen);
+      draw_tile(t);
+      hoisted[i / 32] |= 1u << (i % 32);
+      prio_hoisted_++;
     }
-    
-    off += th.dlen;
+  }
+
+  size_t i = 0;
+  for (const proto::TileView &t : fv) {
+    const bool done = i < cfg::priority_max_tiles && (hoisted[i / 32] & (1u << (i % 32)));
+    i++;
+    if (!done) draw_tile(t);
   }
 
   if (fi.flags & proto::kFlafLastOfFrame) {
-    const uint32_t time_ms = (esp_timer_get_time() - frame_start_us_) / 1000ULL;
+    blit_.flush();
+    const uint64_t now = esp_timer_get_time();
+    const uint32_t time_ms = (now - frame_start_us_) / 1000ULL;
+    // the refinement's pixels were captured with the preview; only the first pass counts
+    if (latency_stats_ && !refinement) record_present_latency_(now);
     frame_stats_bytes_ += frame_bytes_;
     frame_stats_time_ += time_ms;
     frame_stats_count_++;
-    ESP_LOGD(TAG, "frame %lu: tiles %u (%u bytes) - %lu ms", frame_id_, frame_tiles_, frame_bytes_, time_ms);
+    ESP_LOGD(TAG, "frame %lu: tiles %u (%u bytes) - %lu ms", (unsigned long)frame_id_, (unsigned)frame_tiles_,
+             (unsigned)frame_bytes_, (unsigned long)time_ms);
+  }
+}
+
+bool RemoteWebView::priority_rect_(const proto::FrameInfo &fi, int &x0, int &y0, int &x1, int &y1) const {
+  if (!touch_priority_) return false;
+
+  if (fi.flags & proto::kFlagHasPriorityRect) {
+    if (!fi.prio_w || !fi.prio_h) return false;
+    x0 = fi.prio_x; y0 = fi.prio_y;
+    x1 = x0 + fi.prio_w; y1 = y0 + fi.prio_h;
+    return true;
+  }
+
+  const uint64_t touched = last_touch_us_;
+  if (!touched || esp_timer_get_time() - touched > cfg::touch_priority_window_us) return false;
+
+  // touch coordinates are screen space; tiles of a scaled frame are too, so no shift here
+  x0 = (int)last_touch_x_ - cfg::touch_priority_margin_px;
+  y0 = (int)last_touch_y_ - cfg::touch_priority_margin_px;
+  x1 = (int)last_touch_x_ + cfg::touch_priority_margin_px;
+  y1 = (int)last_touch_y_ + cfg::touch_priority_margin_px;
+  return true;
+}
+
+void RemoteWebView::process_glyph_packet_(const uint8_t *data, size_t len) {
+  if (!glyph_cache_) return;
+  if (glyph_reset_) {
+    glyph_reset_ = false;
+    glyphs_.clear();
+  }
+
+  switch ((proto::MsgType)data[0]) {
+    case proto::MsgType::GlyphUpload: {
+      if (len < sizeof(proto::GlyphUploadHeader) || data[1] != proto::kProtocolVersion) break;
+      const uint16_t n = proto::rd16(data + 2);
+      size_t off = sizeof(proto::GlyphUploadHeader);
+      for (uint16_t i = 0; i < n; i++) {
+        if (len - off < 4) break;
+        const uint16_t id = proto::rd16(data + off);
+        const uint8_t w = data[off + 2], h = data[off + 3];
+        off += 4;
+        if (len - off < (size_t)w * h) {
+          ESP_LOGW(TAG, "truncated glyph upload at %u/%u", (unsigned)i, (unsigned)n);
+          break;
+        }
+        glyphs_.put_glyph(id, w, h, data + off);
+        off += (size_t)w * h;
+      }
+      break;
+    }
+
+    case proto::MsgType::Background: {
+      proto::BackgroundInfo bg{};
+      if (!proto::parse_background_packet(data, len, bg)) {
+        ESP_LOGW(TAG, "malformed background message (%u bytes)", (unsigned)len);
+        break;
+      }
+      glyphs_.put_background(bg);
+      break;
+    }
+
+    case proto::MsgType::TextRun: {
+      if (paused_) break;
+      proto::TextRunInfo run{};
+      if (!proto::parse_text_run_packet(data, len, run)) {
+        ESP_LOGW(TAG, "malformed text run (%u bytes)", (unsigned)len);
+        break;
+      }
+      if (run.x >= display_width_ || run.y >= display_height_) break;
+      const uint16_t *px = glyphs_.compose(run);
+      if (!px) break;
+
+      const int w = std::min<int>(run.w, display_width_ - run.x);
+      const int h = std::min<int>(run.h, display_height_ - run.y);
+      if (pixel_format_ == PixelFormat::RGB332)
+        draw_rgb332_from_565_(run.x, run.y, w, h, px, run.w);
+      else
+        present_(run.x, run.y, w, h, (const uint8_t *)px, run.w, display::COLOR_BITNESS_565, false);
+      blit_.flush();
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+void RemoteWebView::process_video_region_packet_(const uint8_t *data, size_t len) {
+  if (!video_region_) return;
+  if (len < sizeof(proto::VideoRegionPacket) || data[1] != proto::kProtocolVersion) return;
+
+  video_reset_ = false;
+  const uint16_t x = proto::rd16(data + 2), y = proto::rd16(data + 4);
+  const uint16_t w = proto::rd16(data + 6), h = proto::rd16(data + 8);
+  if (!w || !h || x >= display_width_ || y >= display_height_ || x + w > display_width_ || y + h > display_height_) {
+    if (w && h) ESP_LOGW(TAG, "video region %ux%u@%u,%u outside the display", w, h, x, y);
+    video_w_ = video_h_ = 0;
+    return;
+  }
+  video_x_ = x; video_y_ = y; video_w_ = w; video_h_ = h;
+  ESP_LOGD(TAG, "video region %ux%u@%u,%u", w, h, x, y);
+}
+
+void RemoteWebView::process_video_frame_(const WsMsg &m) {
+  if (video_reset_) {
+    video_reset_ = false;
+    video_w_ = video_h_ = 0;
+  }
+  if (paused_) return;
+
+  if (esp_timer_get_time() - m.rx_us > cfg::video_max_age_us) {
+    video_stats_.late++;
+    return;
+  }
+
+  const uint8_t *jpeg = m.buf + sizeof(proto::VideoFrameHeader);
+  const size_t jlen = m.len - sizeof(proto::VideoFrameHeader);
+  uint16_t w = 0, h = 0;
+  // the JPEG is drawn without a tile header, so it must not spill outside its rect
+  if (!video_w_ || !proto::jpeg_dimensions(jpeg, jlen, w, h) || w > video_w_ || h > video_h_) {
+    video_stats_.rejected++;
+    return;
+  }
+
+  if (decode_jpeg_tile_to_lcd_((int16_t)video_x_, (int16_t)video_y_, video_w_, jpeg, jlen, 0)) {
+    blit_.flush();
+    video_stats_.decoded++;
+  }
+}
+
+void RemoteWebView::region_mark_(const proto::TileView &th, uint32_t frame_id) {
+  if (!region_frame_ || !region_synced_) return;
+
+  const int c0 = th.x / cfg::refine_cell_px, r0 = th.y / cfg::refine_cell_px;
+  const int c1 = std::min(region_cols_ - 1, (th.x + th.w - 1) / cfg::refine_cell_px);
+  const int r1 = std::min(region_rows_ - 1, (th.y + th.h - 1) / cfg::refine_cell_px);
+  for (int r = r0; r <= r1; r++)
+    for (int c = c0; c <= c1; c++)
+      region_frame_[r * region_cols_ + c] = frame_id;
+}
+
+bool RemoteWebView::region_superseded_(const proto::TileView &th, uint32_t frame_id) const {
+  if (!region_frame_ || !region_synced_) return false;
+
+  const int c0 = th.x / cfg::refine_cell_px, r0 = th.y / cfg::refine_cell_px;
+  const int c1 = std::min(region_cols_ - 1, (th.x + th.w - 1) / cfg::refine_cell_px);
+  const int r1 = std::min(region_rows_ - 1, (th.y + th.h - 1) / cfg::refine_cell_px);
+  for (int r = r0; r <= r1; r++)
+    for (int c = c0; c <= c1; c++)
+      if ((int32_t)(region_frame_[r * region_cols_ + c] - frame_id) > 0) return true;
+  return false;
+}
+
+// rx_us is stamped when the message leaves the socket, so decode backlog does not bias the sample
+void RemoteWebView::process_pong_packet_(const uint8_t *data, size_t len, uint64_t rx_us) {
+  proto::PongInfo pi{};
+  if (!proto::parse_pong_packet(data, len, pi)) return;
+
+  if (clock_resync_) {
+    clock_.reset();
+    clock_resync_ = false;
+  }
+  clock_.add_sample(pi.client_us, pi.server_rx_us, pi.server_tx_us, rx_us);
+  ESP_LOGV(TAG, "clock sync: rtt=%u us offset=%lld us", (unsigned)clock_.rtt_us(), (long long)clock_.offset_us());
+}
+
+void RemoteWebView::process_calibration_packet_(const uint8_t *data, size_t len) {
+  if (!auto_calibrate_) return;
+
+  proto::CalibrationTile tiles[cfg::calibration_max_tiles];
+  size_t n = 0;
+  if (!proto::parse_calibration_packet(data, len, tiles, cfg::calibration_max_tiles, n) || !n) {
+    ESP_LOGW(TAG, "malformed calibration message (%u bytes)", (unsigned)len);
+    return;
+  }
+
+  const uint32_t panel_ns_per_px = measure_panel_ns_per_px_();
+
+  // decode cost per pixel for every (tile size, quality) the server offered; draws are suppressed
+  uint32_t cost_ns_per_px[cfg::calibration_max_tiles];
+  calibrating_ = true;
+  for (size_t i = 0; i < n; i++) {
+    const uint32_t px = (uint32_t)tiles[i].tile_size * tiles[i].tile_size;
+    const uint64_t t0 = esp_timer_get_time();
+    const bool ok = px && decode_jpeg_tile_to_lcd_(0, 0, tiles[i].tile_size, tiles[i].data, tiles[i].dlen, 0);
+    const uint64_t us = esp_timer_get_time() - t0;
+    cost_ns_per_px[i] = ok ? (uint32_t)(us * 1000u / px) : UINT32_MAX;
+    ESP_LOGD(TAG, "calibration: ts=%u q=%u %u B decode=%u us (%u ns/px)", (unsigned)tiles[i].tile_size,
+             (unsigned)tiles[i].quality, (unsigned)tiles[i].dlen, (unsigned)us, (unsigned)cost_ns_per_px[i]);
+  }
+  calibrating_ = false;
+
+  // cheapest tile size first, then the best quality that still fits the frame-time target
+  size_t best = 0;
+  for (size_t i = 1; i < n; i++)
+    if (cost_ns_per_px[i] < cost_ns_per_px[best]) best = i;
+  if (cost_ns_per_px[best] == UINT32_MAX) {
+    ESP_LOGW(TAG, "calibration: no test tile decoded");
+    return;
+  }
+
+  const uint64_t frame_px = (uint64_t)display_width_ * display_height_;
+  auto frame_ms = [&](size_t i) { return (uint32_t)(frame_px * (cost_ns_per_px[i] + panel_ns_per_px) / 1000000u); };
+
+  const uint16_t ts = tiles[best].tile_size;
+  size_t pick = best;
+  for (size_t i = 0; i < n; i++) {
+    if (tiles[i].tile_size != ts || cost_ns_per_px[i] == UINT32_MAX) continue;
+    const bool fits = frame_ms(i) <= cfg::calibration_target_frame_ms;
+    const bool pick_fits = frame_ms(pick) <= cfg::calibration_target_frame_ms;
+    if ((fits && (!pick_fits || tiles[i].quality > tiles[pick].quality)) ||
+        (!fits && !pick_fits && tiles[i].quality < tiles[pick].quality))
+      pick = i;
+  }
+
+  cal_.version = cfg::calibration_version;
+  cal_.width = (uint16_t)display_width_;
+  cal_.height = (uint16_t)display_height_;
+  cal_.tile_size = ts;
+  cal_.quality = tiles[pick].quality;
+  cal_.min_frame_interval = (uint16_t)std::min<uint32_t>(frame_ms(pick) * 12 / 10 + 1, 0xffffu);
+  calibrated_ = true;
+  cal_save_pending_ = true;  // preferences are not thread-safe; loop() writes them
+
+  ESP_LOGI(TAG, "calibrated: tile_size=%u quality=%u min_frame_interval=%u ms (panel %u ns/px)",
+           (unsigned)cal_.tile_size, (unsigned)cal_.quality, (unsigned)cal_.min_frame_interval,
+           (unsigned)panel_ns_per_px);
+  ws_send_calibration_result_();
+  uri_dirty_ = true;
+  // the panel measurement left a blank band at the top; a full frame repaints it (resume() sends one anyway)
+  if (!paused_) ws_send_stream_control_(false);
+}
+
+uint32_t RemoteWebView::measure_panel_ns_per_px_() {
+  // push a blank band through the normal output path; the first frame repaints it
+  const int rows = std::min(cfg::calibration_panel_rows, display_height_);
+  const size_t px = (size_t)display_width_ * rows;
+  uint8_t *buf = (uint8_t *)heap_caps_malloc(px * 2u, MALLOC_CAP_8BIT);
+  if (!buf || !px) {
+    if (buf) free(buf);
+    return 0;
+  }
+  memset(buf, 0, px * 2u);
+
+  const uint64_t t0 = esp_timer_get_time();
+  if (pixel_format_is_gray(pixel_format_))
+    draw_gray_(0, 0, display_width_, rows, buf, display_width_);
+  else if (pixel_format_ == PixelFormat::RGB332)
+    present_(0, 0, display_width_, rows, buf, display_width_, display::COLOR_BITNESS_332, false);
+  else
+    present_(0, 0, display_width_, rows, buf, display_width_, display::COLOR_BITNESS_565, rgb565_big_endian_);
+  blit_.flush();
+  const uint64_t us = esp_timer_get_time() - t0;
+
+  free(buf);
+  return (uint32_t)(us * 1000u / px);
+}
+
+void RemoteWebView::record_present_latency_(uint64_t now) {
+  // without a synced clock the capture time is meaningless, so fall back to the first frame after a touch
+  const bool have_capture = frame_capture_us_ && clock_.valid();
+  const uint64_t captured = have_capture ? clock_.to_client_us(frame_capture_us_) : 0;
+
+  if (have_capture && captured <= now)
+    capture_latency_.add((uint32_t)std::min<uint64_t>(now - captured, 0xffffffffu));
+
+  const uint64_t touched = touch_pending_us_;
+  if (touched && (!have_capture || captured >= touched)) {
+    touch_latency_[touch_pending_ctl_ ? 1 : 0].add((uint32_t)std::min<uint64_t>(now - touched, 0xffffffffu));
+    touch_pending_us_ = 0;
+  }
+}
+
+void RemoteWebView::log_latency_stats_() {
+  ESP_LOGD(TAG, "capture->present: n=%u p50=%u p95=%u max=%u ms (rtt=%u us)",
+           (unsigned)capture_latency_.count(), (unsigned)capture_latency_.percentile_ms(50),
+           (unsigned)capture_latency_.percentile_ms(95), (unsigned)capture_latency_.max_ms(),
+           (unsigned)clock_.rtt_us());
+  // split by the socket the touch left on, so cc=1 and cc=0 can be compared under the same load
+  static const char *const kVia[2] = {"shared socket", "control channel"};
+  for (int i = 0; i < 2; i++) {
+    const LatencyHistogram &h = touch_latency_[i];
+    if (!h.count()) continue;
+    ESP_LOGD(TAG, "touch->present (%s): n=%u p50=%u p95=%u max=%u ms", kVia[i], (unsigned)h.count(),
+             (unsigned)h.percentile_ms(50), (unsigned)h.percentile_ms(95), (unsigned)h.max_ms());
   }
+  capture_latency_.reset();
+  touch_latency_[0].reset();
+  touch_latency_[1].reset();
 }
 
 void RemoteWebView::process_frame_stats_packet_(const uint8_t *data, size_t len)
@@ -357,6 +1055,31 @@ void RemoteWebView::process_frame_stats_packet_(const uint8_t *data, size_t len)
     avg_render_time = frame_stats_time_ / frame_stats_count_;
 
   ESP_LOGD(TAG, "sending frame stats: avg_time=%u ms, bytes=%u", (unsigned)avg_render_time, (unsigned)frame_stats_bytes_);
+  if (latency_stats_) log_latency_stats_();
+  if (glyph_cache_) {
+    const GlyphCache::Stats gs = glyphs_.take_stats();
+    ESP_LOGD(TAG, "glyphs: %u cached (%u KB), %u runs in %u bytes, misses glyph=%u bg=%u, rejected=%u",
+             (unsigned)glyphs_.glyph_count(), (unsigned)(glyphs_.atlas_used() / 1024), (unsigned)gs.runs,
+             (unsigned)gs.run_bytes, (unsigned)gs.glyph_misses, (unsigned)gs.bg_misses, (unsigned)gs.rejected);
+  }
+  if (video_region_) {
+    const VideoStats vs = video_stats_;
+    video_stats_ = VideoStats{};
+    ESP_LOGD(TAG, "video: decoded=%u superseded=%u late=%u rejected=%u", (unsigned)vs.decoded,
+             (unsigned)vs.superseded, (unsigned)vs.late, (unsigned)vs.rejected);
+  }
+  if (touch_priority_) {
+    ESP_LOGD(TAG, "priority: %u tiles drawn ahead of wire order", (unsigned)prio_hoisted_);
+    prio_hoisted_ = 0;
+  }
+  if (blit_.running()) {
+    blit_.flush();
+    const BlitStage::Stats bs = blit_.take_stats();
+    // share of panel time that ran concurrently with decoding instead of stalling it
+    const uint32_t hidden = bs.busy_us > bs.stall_us ? (uint32_t)((bs.busy_us - bs.stall_us) * 100 / bs.busy_us) : 0;
+    ESP_LOGD(TAG, "blit: %u strips, %u KB, busy=%u ms stall=%u ms overlap=%u%%", (unsigned)bs.strips,
+             (unsigned)(bs.bytes / 1024), (unsigned)(bs.busy_us / 1000), (unsigned)(bs.stall_us / 1000), (unsigned)hidden);
+  }
   uint8_t pkt[sizeof(proto::FrameStatsPacket)];
   const size_t n = proto::build_frame_stats_packet(avg_render_time, frame_stats_bytes_, pkt);
 
@@ -365,21 +1088,23 @@ void RemoteWebView::process_frame_stats_packet_(const uint8_t *data, size_t len)
   frame_stats_bytes_ = 0;
 
   const TickType_t to = pdMS_TO_TICKS(50);
-  if (xSemaphoreTake(ws_send_mtx_, to) != pdTRUE)
-    return;
-
-  esp_websocket_client_send_bin(ws_client_, (const char*)pkt, (int)n, to);
-  xSemaphoreGive(ws_send_mtx_);
+  ws_send_control_(pkt, n, to, to);
 }
 
-bool RemoteWebView::decode_jpeg_tile_to_lcd_(int16_t dst_x, int16_t dst_y, const uint8_t *data, size_t len) {
+bool RemoteWebView::decode_jpeg_tile_to_lcd_(int16_t dst_x, int16_t dst_y, uint16_t dst_w, const uint8_t *data, size_t len,
+                                             uint8_t shift) {
   if (!data || !len) return false;
 
 #if REMOTE_WEBVIEW_HW_JPEG
-  if (hw_dec_ && hw_decode_input_buf_ && hw_decode_output_buf_) {
+  // the HW engine cannot downscale, so a full-size tile in a scaled frame goes to JPEGDEC
+  if (hw_dec_ && hw_decode_input_buf_ && hw_decode_output_buf_ && pixel_format_ == PixelFormat::RGB565) {
     jpeg_decode_picture_info_t hdr{};
     if (jpeg_decoder_get_info(data, (uint32_t)len, &hdr) != ESP_OK || !hdr.width || !hdr.height) {
-      return decode_jpeg_tile_software_(dst_x, dst_y, data, len);
+      return decode_jpeg_tile_software_(dst_x, dst_y, dst_w, data, len, shift);
+    }
+
+    if (shift && hdr.width >= dst_w) {
+      return decode_jpeg_tile_software_(dst_x, dst_y, dst_w, data, len, shift);
     }
 
     const int aligned_w = (hdr.width  + 15) & ~15;
@@ -388,12 +1113,12 @@ bool RemoteWebView::decode_jpeg_tile_to_lcd_(int16_t dst_x, int16_t dst_y, const
 
     if (aligned_w != (int)hdr.width) {
       ESP_LOGW(TAG, "jpeg dimensions not aligned: %u x %u", (unsigned)hdr.width, (unsigned)hdr.height);
-      return decode_jpeg_tile_software_(dst_x, dst_y, data, len);
+      return decode_jpeg_tile_software_(dst_x, dst_y, dst_w, data, len, shift);
     }
     
     if (len > hw_decode_input_size_ || out_sz > hw_decode_output_size_) {
       ESP_LOGW(TAG, "tile too large for HW decoder buffers");
-      return decode_jpeg_tile_software_(dst_x, dst_y, data, len);
+      return decode_jpeg_tile_software_(dst_x, dst_y, dst_w, data, len, shift);
     }
 
     jpeg_decode_cfg_t jcfg{};
@@ -408,31 +1133,54 @@ bool RemoteWebView::decode_jpeg_tile_to_lcd_(int16_t dst_x, int16_t dst_y, const
                                         hw_decode_output_buf_, (uint32_t)hw_decode_output_size_, &written);
 
     if (dr != ESP_OK) {
-      return decode_jpeg_tile_software_(dst_x, dst_y, data, len);
+      return decode_jpeg_tile_software_(dst_x, dst_y, dst_w, data, len, shift);
     }
 
-    display_->draw_pixels_at(dst_x, dst_y, (int)hdr.width, (int)hdr.height, hw_decode_output_buf_,
-        esphome::display::COLOR_ORDER_RGB,
-        esphome::display::COLOR_BITNESS_565,
-        rgb565_big_endian_);
+    if (shift) {
+      draw_upscaled_(dst_x, dst_y, (int)hdr.width, (int)hdr.height, (const uint16_t *)hw_decode_output_buf_,
+                     (int)hdr.width, shift);
+      return true;
+    }
+
+    present_(dst_x, dst_y, (int)hdr.width, (int)hdr.height, hw_decode_output_buf_, (int)hdr.width,
+             esphome::display::COLOR_BITNESS_565, rgb565_big_endian_);
 
     return true;
   }
 #endif  // REMOTE_WEBVIEW_HW_JPEG
 
-  return decode_jpeg_tile_software_(dst_x, dst_y, data, len);
+  return decode_jpeg_tile_software_(dst_x, dst_y, dst_w, data, len, shift);
 }
 
-bool RemoteWebView::decode_jpeg_tile_software_(int16_t dst_x, int16_t dst_y, const uint8_t *data, size_t len) {
+bool RemoteWebView::decode_jpeg_tile_software_(int16_t dst_x, int16_t dst_y, uint16_t dst_w, const uint8_t *data, size_t len,
+                                               uint8_t shift) {
   if (!jd_.openRAM((uint8_t*)data, (int)len, &RemoteWebView::jpeg_draw_cb_s_)) {
     ESP_LOGE(TAG, "openRAM failed (len=%u) err=%d", (unsigned)len, jd_.getLastError());
     return false;
   }
+  jd_.setUserPointer(this);
 
   jd_.setMaxOutputSize(8 * 2048);
-  jd_.setPixelType(rgb565_big_endian_ ? RGB565_BIG_ENDIAN : RGB565_LITTLE_ENDIAN);
+  if (pixel_format_is_gray(pixel_format_))
+    jd_.setPixelType(EIGHT_BIT_GRAYSCALE);
+  else if (pixel_format_ == PixelFormat::RGB332)
+    jd_.setPixelType(RGB565_LITTLE_ENDIAN);  // read back as native uint16 for conversion
+  else
+    jd_.setPixelType(rgb565_big_endian_ ? RGB565_BIG_ENDIAN : RGB565_LITTLE_ENDIAN);
+
+  // A scaled frame may carry either a pre-shrunk tile (saves bandwidth) or a full-size
+  // one (saves IDCT work); the latter is shrunk by JPEGDEC and both are upscaled on blit.
+  int options = 0;
+  if (shift && jd_.getWidth() >= dst_w) {
+    static constexpr int kScaleOpt[4] = {0, JPEG_SCALE_HALF, JPEG_SCALE_QUARTER, JPEG_SCALE_EIGHTH};
+    options = kScaleOpt[shift];
+  }
+  decode_x_ = dst_x;
+  decode_y_ = dst_y;
+  decode_shift_ = shift;
 
-  const int rc = jd_.decode(dst_x, dst_y, 0);
+  const int rc = jd_.decode(dst_x, dst_y, options);
+  decode_shift_ = 0;
   if (rc == 0) {
     ESP_LOGE(TAG, "decode rc=%d err=%d", rc, jd_.getLastError());
     jd_.close();
@@ -443,10 +1191,18 @@ bool RemoteWebView::decode_jpeg_tile_software_(int16_t dst_x, int16_t dst_y, con
 }
 
 int RemoteWebView::jpeg_draw_cb_s_(JPEGDRAW *p) {
-  return self_ ? self_->jpeg_draw_cb_(p) : 0;
+  auto *self = reinterpret_cast<RemoteWebView*>(p->pUser);
+  return self ? self->jpeg_draw_cb_(p) : 0;
 }
 
 int RemoteWebView::jpeg_draw_cb_(JPEGDRAW *p) {
+  if (decode_shift_) {
+    const int s = decode_shift_;
+    draw_upscaled_(decode_x_ + ((p->x - decode_x_) << s), decode_y_ + ((p->y - decode_y_) << s),
+                   p->iWidth, p->iHeight, p->pPixels, p->iWidth, decode_shift_);
+    return 1;
+  }
+
   int32_t x = p->x, y = p->y, w = p->iWidth, h = p->iHeight;
   
   if (x >= display_width_ || y >= display_height_) return 1;
@@ -454,22 +1210,181 @@ int RemoteWebView::jpeg_draw_cb_(JPEGDRAW *p) {
   if (y + h > display_height_) h = display_height_ - y;
   if (w <= 0 || h <= 0) return 1;
 
-  display_->draw_pixels_at(
-      x, y, w, h,
-      (const uint8_t *)p->pPixels,
-      esphome::display::COLOR_ORDER_RGB,
-      esphome::display::COLOR_BITNESS_565,
-      rgb565_big_endian_
-  );
+  switch (pixel_format_) {
+    case PixelFormat::RGB332:
+      draw_rgb332_from_565_(x, y, w, h, p->pPixels, p->iWidth);
+      break;
+    case PixelFormat::GRAY8:
+    case PixelFormat::GRAY4:
+    case PixelFormat::MONO:
+      draw_gray_(x, y, w, h, (const uint8_t *)p->pPixels, p->iWidth);
+      break;
+    default:
+      present_(x, y, w, h, (const uint8_t *)p->pPixels, p->iWidth,
+               esphome::display::COLOR_BITNESS_565, rgb565_big_endian_);
+      break;
+  }
 
   return 1;
 }
 
-bool RemoteWebView::ws_send_touch_event_(proto::TouchType type, int x, int y, uint8_t pid) {
-  if (touch_disabled_)
+bool RemoteWebView::draw_raw_tile_(proto::Encoding enc, const proto::TileView &t) {
+  int w = t.w, h = t.h;
+  if (t.x >= display_width_ || t.y >= display_height_) return false;
+  if (t.x + w > display_width_) w = display_width_ - t.x;
+  if (t.y + h > display_height_) h = display_height_ - t.y;
+
+  size_t need = 0;
+  switch (enc) {
+    case proto::Encoding::RAW565: need = (size_t)t.w * t.h * 2u; break;
+    case proto::Encoding::RAW332:
+    case proto::Encoding::GRAY8:  need = (size_t)t.w * t.h; break;
+    case proto::Encoding::GRAY4:  need = (size_t)((t.w + 1) / 2) * t.h; break;
+    case proto::Encoding::MONO1:  need = (size_t)((t.w + 7) / 8) * t.h; break;
+    default:
+      ESP_LOGW(TAG, "unsupported tile encoding %d", (int)enc);
+      return false;
+  }
+  if (t.dlen < need) {
+    ESP_LOGW(TAG, "short raw tile: %u < %u", (unsigned)t.dlen, (unsigned)need);
     return false;
+  }
+
+  switch (enc) {
+    case proto::Encoding::RAW565:
+      present_(t.x, t.y, w, h, t.data, t.w, esphome::display::COLOR_BITNESS_565, rgb565_big_endian_);
+      break;
+    case proto::Encoding::RAW332:
+      present_(t.x, t.y, w, h, t.data, t.w, esphome::display::COLOR_BITNESS_332, false);
+      break;
+    case proto::Encoding::GRAY8:
+      draw_gray_(t.x, t.y, w, h, t.data, t.w);
+      break;
+    case proto::Encoding::GRAY4: {
+      const size_t row = (t.w + 1) / 2;
+      for (int r = 0; r < h; r++) {
+        const uint8_t *s = t.data + r * row;
+        for (int c = 0; c < w; c++) {
+          const uint8_t q = (c & 1) ? (s[c >> 1] & 0x0F) : (s[c >> 1] >> 4);
+          const uint8_t g = (uint8_t)(q * 17);
+          display_->draw_pixel_at(t.x + c, t.y + r, Color(g, g, g));
+        }
+      }
+      break;
+    }
+    case proto::Encoding::MONO1: {
+      const size_t row = (t.w + 7) / 8;
+      for (int r = 0; r < h; r++) {
+        const uint8_t *s = t.data + r * row;
+        for (int c = 0; c < w; c++) {
+          const uint8_t g = (s[c >> 3] & (0x80 >> (c & 7))) ? 255 : 0;
+          display_->draw_pixel_at(t.x + c, t.y + r, Color(g, g, g));
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return true;
+}
 
-  if (!ws_client_ || !ws_send_mtx_ || !esp_websocket_client_is_connected(ws_client_))
+void RemoteWebView::draw_rgb332_from_565_(int x, int y, int w, int h, const uint16_t *src, int stride) {
+  const int rows_per_chunk = std::max(1, (int)(cfg::convert_buf_px / (size_t)w));
+  for (int r0 = 0; r0 < h; r0 += rows_per_chunk) {
+    const int rows = std::min(rows_per_chunk, h - r0);
+    for (int r = 0; r < rows; r++) {
+      const uint16_t *s = src + (size_t)(r0 + r) * stride;
+      uint8_t *d = convert_buf_ + (size_t)r * w;
+      for (int c = 0; c < w; c++) d[c] = rgb565_to_332(s[c]);
+    }
+    present_(x, y + r0, w, rows, convert_buf_, w, esphome::display::COLOR_BITNESS_332, false);
+  }
+}
+
+void RemoteWebView::draw_gray_(int x, int y, int w, int h, const uint8_t *src, int stride) {
+  if (calibrating_) return;
+  // ColorBitness has no gray or 1-bit variant; buffered mono/gray panels pack Color on their side
+  for (int r = 0; r < h; r++) {
+    const uint8_t *s = src + (size_t)r * stride;
+    for (int c = 0; c < w; c++) {
+      const uint8_t g = quantize_gray(pixel_format_, s[c], x + c, y + r);
+      display_->draw_pixel_at(x + c, y + r, Color(g, g, g));
+    }
+  }
+}
+
+void RemoteWebView::draw_upscaled_(int dst_x, int dst_y, int w, int h, const uint16_t *src, int stride, uint8_t shift) {
+  const int f = 1 << shift;
+  if (dst_x >= display_width_ || dst_y >= display_height_) return;
+
+  int ow = w << shift;
+  if (dst_x + ow > display_width_) ow = display_width_ - dst_x;
+  if (ow <= 0 || (size_t)ow * (size_t)f > scale_buf_px_) return;
+
+  for (int r = 0; r < h; r++) {
+    const int oy = dst_y + (r << shift);
+    if (oy >= display_height_) break;
+    const int rows = (oy + f > display_height_) ? (display_height_ - oy) : f;
+
+    const uint16_t *s = src + (size_t)r * (size_t)stride;
+    for (int i = 0; i < ow; i++)
+      scale_buf_[i] = s[i >> shift];
+    for (int k = 1; k < rows; k++)
+      memcpy(scale_buf_ + (size_t)k * ow, scale_buf_, (size_t)ow * 2u);
+
+    present_(dst_x, oy, ow, rows, (const uint8_t *)scale_buf_, ow, esphome::display::COLOR_BITNESS_565,
+             rgb565_big_endian_);
+  }
+}
+
+void RemoteWebView::present_(int x, int y, int w, int h, const uint8_t *src, int stride_px,
+                             display::ColorBitness bitness, bool big_endian) {
+  if (calibrating_) return;
+
+  const size_t bpp = bitness == display::COLOR_BITNESS_332 ? 1u : 2u;
+  const size_t row_bytes = (size_t)w * bpp;
+
+  if (!blit_.running() || row_bytes > blit_.strip_bytes()) {
+    blit_.flush();
+    display_->draw_pixels_at(x, y, w, h, src, display::COLOR_ORDER_RGB, bitness, big_endian, 0, 0, stride_px - w);
+    return;
+  }
+
+  const int rows_per_strip = (int)(blit_.strip_bytes() / row_bytes);
+  for (int r0 = 0; r0 < h; r0 += rows_per_strip) {
+    const int rows = std::min(rows_per_strip, h - r0);
+    uint8_t *buf = blit_.acquire();
+    for (int r = 0; r < rows; r++)
+      memcpy(buf + (size_t)r * row_bytes, src + ((size_t)(r0 + r) * stride_px) * bpp, row_bytes);
+    blit_.submit(buf, x, y + r0, w, rows, bitness, big_endian);
+  }
+}
+
+// Control traffic prefers the dedicated connection; without one (or while it reconnects)
+// it shares the frame stream's socket as before.
+bool RemoteWebView::ws_send_control_(const uint8_t *pkt, size_t n, TickType_t lock_to, TickType_t send_to,
+                                     bool *via_ctl) {
+  esp_websocket_client_handle_t c = ctl_client_;
+  SemaphoreHandle_t mtx = ctl_send_mtx_;
+  if (!c || !mtx || !esp_websocket_client_is_connected(c)) {
+    c = ws_client_;
+    mtx = ws_send_mtx_;
+  }
+  if (!c || !mtx || !esp_websocket_client_is_connected(c))
+    return false;
+
+  if (xSemaphoreTake(mtx, lock_to) != pdTRUE)
+    return false;
+
+  const int r = esp_websocket_client_send_bin(c, (const char*)pkt, (int)n, send_to);
+  xSemaphoreGive(mtx);
+  if (via_ctl) *via_ctl = c != ws_client_;
+  return r == (int)n;
+}
+
+bool RemoteWebView::ws_send_touch_event_(proto::TouchType type, int x, int y, uint8_t pid) {
+  if (touch_disabled_)
     return false;
 
   if (x < 0) x = 0; if (y < 0) y = 0;
@@ -478,17 +1393,29 @@ bool RemoteWebView::ws_send_touch_event_(proto::TouchType type, int x, int y, ui
   uint8_t pkt[sizeof(proto::TouchPacket)];
   const size_t n = proto::build_touch_packet(type, pid, x, y, pkt);
 
-  const TickType_t to = pdMS_TO_TICKS(50);
-  if (xSemaphoreTake(ws_send_mtx_, pdMS_TO_TICKS(10)) != pdTRUE)
+  bool via_ctl = false;
+  if (!ws_send_control_(pkt, n, pdMS_TO_TICKS(10), pdMS_TO_TICKS(50), &via_ctl))
     return false;
 
-  int r = esp_websocket_client_send_bin(ws_client_, (const char*)pkt, (int)n, to);
-  xSemaphoreGive(ws_send_mtx_);
-  return r == (int)n;
+  if (touch_priority_) {
+    // a bare release carries no position; keep steering toward where the finger was
+    if (type != proto::TouchType::Up || x || y) {
+      last_touch_x_ = (uint16_t)x;
+      last_touch_y_ = (uint16_t)y;
+    }
+    last_touch_us_ = esp_timer_get_time();
+  }
+  if (type != proto::TouchType::Move) {
+    if (!touch_pending_us_) {
+      touch_pending_ctl_ = via_ctl;
+      touch_pending_us_ = esp_timer_get_time();
+    }
+  }
+  return true;
 }
 
 bool RemoteWebView::ws_send_open_url_(const char *url, uint16_t flags) {
-  if (!ws_client_ || !ws_send_mtx_ ||  !url || !esp_websocket_client_is_connected(ws_client_))
+  if (!url)
     return false;
 
   const uint32_t n = (uint32_t) strlen(url);
@@ -501,33 +1428,39 @@ bool RemoteWebView::ws_send_open_url_(const char *url, uint16_t flags) {
   if (!pkt) return false;
 
   const size_t written = proto::build_open_url_packet(url, flags, pkt, total);
-  bool ok = false;
-  if (written) {
-    if (xSemaphoreTake(ws_send_mtx_, pdMS_TO_TICKS(50)) == pdTRUE) {
-      const int r = esp_websocket_client_send_bin(ws_client_, (const char *) pkt, (int) written, pdMS_TO_TICKS(200));
-      xSemaphoreGive(ws_send_mtx_);
-      ok = (r == (int) written);
-    }
-  }
+  const bool ok = written && ws_send_control_(pkt, written, pdMS_TO_TICKS(50), pdMS_TO_TICKS(200));
   free(pkt);
   return ok;
 }
 
 bool RemoteWebView::ws_send_keepalive_() {
-  if (!ws_client_ || !ws_send_mtx_ || !esp_websocket_client_is_connected(ws_client_))
-    return false;
-
-  uint8_t pkt[sizeof(proto::KeepalivePacket)];
-  const size_t n = proto::build_keepalive_packet(pkt);
+  uint8_t pkt[sizeof(proto::PingPacket)];
+  // the timestamped form is only understood by servers that were asked for latency stats
+  const size_t n = latency_stats_ ? proto::build_ping_packet(esp_timer_get_time(), pkt)
+                                  : proto::build_keepalive_packet(pkt);
   if (!n) return false;
 
   const TickType_t to = pdMS_TO_TICKS(50);
-  if (xSemaphoreTake(ws_send_mtx_, to) != pdTRUE)
-    return false;
+  return ws_send_control_(pkt, n, to, to);
+}
 
-  const int r = esp_websocket_client_send_bin(ws_client_, (const char*)pkt, (int)n, to);
-  xSemaphoreGive(ws_send_mtx_);
-  return r == (int)n;
+bool RemoteWebView::ws_send_stream_control_(bool pause) {
+  uint8_t pkt[sizeof(proto::StreamControlPacket)];
+  const size_t n = proto::build_stream_control_packet(pause, pkt);
+
+  const TickType_t to = pdMS_TO_TICKS(50);
+  return ws_send_control_(pkt, n, to, to);
+}
+
+bool RemoteWebView::ws_send_calibration_result_() {
+  uint8_t pkt[sizeof(proto::CalibrationResultPacket)];
+  const size_t n = proto::build_calibration_result_packet(
+      tile_size_ >= 0 ? (uint16_t)tile_size_ : cal_.tile_size,
+      jpeg_quality_ >= 0 ? (uint8_t)jpeg_quality_ : cal_.quality,
+      min_frame_interval_ >= 0 ? (uint16_t)min_frame_interval_ : cal_.min_frame_interval, pkt);
+
+  const TickType_t to = pdMS_TO_TICKS(50);
+  return ws_send_control_(pkt, n, to, to);
 }
 
 void RemoteWebViewTouchListener::update(const touchscreen::TouchPoints_t &pts) {
@@ -613,6 +1546,12 @@ void RemoteWebView::append_q_str_(std::string &s, const char *k, const char *v)
 std::string RemoteWebView::resolve_device_id_() const {
   if (!device_id_.empty()) return device_id_;
 
+#if REMOTE_WEBVIEW_HOST
+  char host[48] = {0};
+  if (gethostname(host, sizeof(host) - 1) != 0 || !host[0])
+    snprintf(host, sizeof(host), "%08lx", (unsigned long)esp_random());
+  return std::string("host-") + host;
+#else
   uint8_t mac[6] = {0};
   esp_err_t err = ESP_FAIL;
   
@@ -643,6 +1582,16 @@ std::string RemoteWebView::resolve_device_id_() const {
   snprintf(buf, sizeof(buf), "esp32-%02x%02x%02x%02x%02x%02x",
            mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
   return std::string(buf);
+#endif  // REMOTE_WEBVIEW_HOST
+}
+
+// the control socket only needs to name the session it belongs to
+std::string RemoteWebView::build_ctl_uri_() const {
+  std::string uri = "ws://" + server_host_ + ":" + std::to_string(server_port_) + "/";
+  const std::string id = resolve_device_id_();
+  append_q_str_(uri, "id", id.c_str());
+  append_q_str_(uri, "ch", "ctl");
+  return uri;
 }
 
 std::string RemoteWebView::build_ws_uri_() const {
@@ -657,14 +1606,25 @@ std::string RemoteWebView::build_ws_uri_() const {
   append_q_int_(uri, "h", display_height_);
 
   append_q_int_(uri,   "r",    rotation_);
-  append_q_int_(uri,   "ts",   tile_size_);
+  // explicit YAML values always win over calibrated ones
+  const bool cal = auto_calibrate_ && calibrated_;
+  append_q_int_(uri,   "ts",   tile_size_ >= 0 || !cal ? tile_size_ : cal_.tile_size);
   append_q_int_(uri,   "fftc", full_frame_tile_count_);
   append_q_float_(uri, "ffat", full_frame_area_threshold_);
   append_q_int_(uri,   "ffe",  full_frame_every_);
   append_q_int_(uri,   "enf",  every_nth_frame_);
-  append_q_int_(uri,   "mfi",  min_frame_interval_);
-  append_q_int_(uri,   "q",    jpeg_quality_);
+  append_q_int_(uri,   "mfi",  min_frame_interval_ >= 0 || !cal ? min_frame_interval_ : cal_.min_frame_interval);
+  append_q_int_(uri,   "q",    jpeg_quality_ >= 0 || !cal ? jpeg_quality_ : cal_.quality);
   append_q_int_(uri,   "mbpm", max_bytes_per_msg_);
+  append_q_int_(uri,   "gs",   gesture_scale_);
+  if (pixel_format_ != PixelFormat::RGB565) append_q_str_(uri, "pf", pixel_format_token(pixel_format_));
+  append_q_int_(uri,   "pq",   preview_quality_);
+  if (latency_stats_) append_q_int_(uri, "lat", 1);
+  if (auto_calibrate_ && !calibrated_) append_q_int_(uri, "cal", 1);
+  if (control_channel_) append_q_int_(uri, "cc", 1);
+  if (touch_priority_) append_q_int_(uri, "tp", 1);
+  if (glyph_cache_) append_q_int_(uri, "gc", 1);
+  if (video_region_) append_q_int_(uri, "vr", 1);
 
   return uri;
 }
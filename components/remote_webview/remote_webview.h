@@ -1,8 +1,16 @@
 #pragma once
 #include "esphome/core/component.h"
+#include "esphome/core/preferences.h"
 #include "esphome/components/display/display.h"
 #include "esphome/components/touchscreen/touchscreen.h"
 #include "JPEGDEC.h"
+#include "blit_stage.h"
+#include "decode_pool.h"
+#include "glyph_cache.h"
+#include "latency_stats.h"
+#include "memory_plan.h"
+#include "message_pool.h"
+#include "pixel_format.h"
 #include "protocol.h"
 #include "remote_webview_config.h"
 
@@ -18,6 +26,11 @@
 #else
   #define REMOTE_WEBVIEW_HW_JPEG 0
 #endif
+#if defined(CONFIG_IDF_TARGET_LINUX)
+  #define REMOTE_WEBVIEW_HOST 1
+#else
+  #define REMOTE_WEBVIEW_HOST 0
+#endif
 #if defined(CONFIG_IDF_TARGET_ESP32P4)
   #include "esp_cache.h"
   #define REMOTE_WEBVIEW_HAS_CACHE_MSYNC 1
@@ -45,11 +58,29 @@ class RemoteWebView : public Component {
   void set_max_bytes_per_msg(int v) { max_bytes_per_msg_ = v; }
   void set_big_endian(bool v) { rgb565_big_endian_ = v; }
   void set_rotation(int v) { rotation_ = v; }
+  void set_gesture_scale(int v) { gesture_scale_ = v; }
+  void set_preview_quality(int v) { preview_quality_ = v; }
+  void set_latency_stats(bool v) { latency_stats_ = v; }
+  void set_memory_budget(int v) { memory_budget_ = v; }
+  void set_decode_workers(int v) { decode_workers_ = v; }
+  void set_pixel_format(PixelFormat v) { pixel_format_ = v; }
+  void set_async_blit(bool v) { async_blit_ = v; }
+  void set_auto_calibrate(bool v) { auto_calibrate_ = v; }
+  void set_control_channel(bool v) { control_channel_ = v; }
+  void set_touch_priority(bool v) { touch_priority_ = v; }
+  void set_glyph_cache(bool v) { glyph_cache_ = v; }
+  void set_video_region(bool v) { video_region_ = v; }
   void disable_touch(bool disable);
   bool open_url(const std::string &s);
+  // Stops frame streaming (e.g. while the backlight is off); resume() gets one catch-up full frame.
+  void pause();
+  void resume();
+  bool is_paused() const { return paused_; }
+  // Logs the cumulative stream counters now rather than at the next periodic dump.
+  void log_counters() { log_counters_(); }
 
   void setup() override;
-  void loop() override {}
+  void loop() override;
   void dump_config() override;
   float get_setup_priority() const override { return setup_priority::LATE; }
 
@@ -58,17 +89,33 @@ class RemoteWebView : public Component {
     uint8_t *buf{nullptr};
     size_t   len{0};
     void    *client{nullptr}; // opaque esp_websocket_client_handle_t
+    uint64_t rx_us{0};        // when the last fragment arrived
+  };
+  struct CtlMsg {
+    uint64_t rx_us;
+    uint8_t  len;
+    uint8_t  data[cfg::ctl_msg_max];
   };
   struct WsReasm {
     uint8_t *buf{nullptr};
     size_t total{0}, filled{0};
   };
+  // cumulative since boot, so long soak runs show drift in drops and heap
+  struct StreamCounters {
+    uint32_t messages{0};
+    uint64_t bytes{0};
+    uint32_t dropped_queue_full{0};
+    uint32_t dropped_oversize{0};
+    uint32_t alloc_failed{0};
+    uint32_t bad_fragments{0};
+    uint32_t reconnects{0};
+    uint32_t queue_peak{0};
+  };
 
   static constexpr bool     kCoalesceMoves  = cfg::coalesce_moves;
   static constexpr uint32_t kMoveRateHz     = cfg::move_rate_hz;
   static constexpr uint32_t kMoveIntervalUs = (kMoveRateHz ? (1000000u / kMoveRateHz) : 0);
 
-  static RemoteWebView *self_;
   display::Display *display_{nullptr};
   touchscreen::Touchscreen *touch_ = nullptr;
   class RemoteWebViewTouchListener *touch_listener_ = nullptr;
@@ -88,7 +135,39 @@ class RemoteWebView : public Component {
   int max_bytes_per_msg_{-1};
   bool rgb565_big_endian_{true};
   int rotation_{0};
+  int gesture_scale_{-1};
+  int preview_quality_{-1};
+  bool latency_stats_{false};
+  int memory_budget_{-1};
+  MemoryPlan plan_;
+  MessagePool pool_;
+  int decode_workers_{-1};
+  PixelFormat pixel_format_{PixelFormat::RGB565};
+  uint8_t *convert_buf_{nullptr};
+  bool async_blit_{false};
+  BlitStage blit_;
+
+  // persisted outcome of the calibration sweep; applies only to options left unset in YAML
+  struct CalibrationResult {
+    uint32_t version;
+    uint16_t width, height;
+    uint16_t tile_size;
+    uint8_t  quality;
+    uint16_t min_frame_interval;
+  };
+  bool auto_calibrate_{false};
+  bool calibrated_{false};
+  volatile bool calibrating_{false};
+  volatile bool cal_save_pending_{false};
+  volatile bool uri_dirty_{false};
+  CalibrationResult cal_{};
+  ESPPreferenceObject cal_pref_;
+  int decode_worker_{-1};
+  WsReasm reasm_{};
+  StreamCounters counters_{};
+  uint64_t last_counters_log_us_{0};
   bool touch_disabled_{false};
+  volatile bool paused_{false};
 
 #if REMOTE_WEBVIEW_HW_JPEG
   jpeg_decoder_handle_t hw_dec_{nullptr};
@@ -98,11 +177,55 @@ class RemoteWebView : public Component {
   size_t hw_decode_output_size_{0};
 #endif
 
+  uint16_t *scale_buf_{nullptr};
+  size_t    scale_buf_px_{0};
+  int16_t   decode_x_{0};
+  int16_t   decode_y_{0};
+  uint8_t   decode_shift_{0};
+
+  // id of the newest non-refinement frame drawn into each refine_cell_px cell
+  uint32_t *region_frame_{nullptr};
+  int       region_cols_{0};
+  int       region_rows_{0};
+  bool      region_synced_{false};
+
   uint64_t last_move_us_{0};
   uint64_t last_keepalive_us_{0};
+
+  ClockSync clock_;
+  bool clock_resync_{false};
+  uint64_t frame_capture_us_{0};
+  uint64_t touch_pending_us_{0};  // oldest touch not yet reflected on screen
+  bool touch_pending_ctl_{false};  // ... and whether it went out on the control channel
+  LatencyHistogram capture_latency_;
+  LatencyHistogram touch_latency_[2];  // [0] shared socket, [1] control channel
+
+  // decode tiles under the last touch (or the server's priority rect) before the rest of the message
+  bool touch_priority_{false};
+  volatile uint64_t last_touch_us_{0};
+  volatile uint16_t last_touch_x_{0}, last_touch_y_{0};
+  uint32_t prio_hoisted_{0};
+
+  bool glyph_cache_{false};
+  volatile bool glyph_reset_{false};  // set on reconnect, applied by the decode task
+  GlyphCache glyphs_;
+
+  // fixed-rect video: bare JPEGs on their own queue, decoded only when no UI message is waiting
+  struct VideoStats {
+    uint32_t decoded{0};
+    uint32_t superseded{0};  // replaced in the queue by a newer frame
+    uint32_t late{0};        // older than video_max_age_us when its turn came
+    uint32_t rejected{0};    // no region, or JPEG not matching it
+  };
+  bool video_region_{false};
+  volatile bool video_reset_{false};
+  QueueHandle_t q_video_{nullptr};
+  uint16_t video_x_{0}, video_y_{0}, video_w_{0}, video_h_{0};
+  VideoStats video_stats_;
   
   uint64_t frame_start_us_ = 0;
   uint32_t frame_id_{0xffffffffu};
+  bool     frame_refinement_{false};  // the pass being accounted is a refinement of frame_id_
   uint16_t frame_tiles_{0};
   size_t   frame_bytes_{0};
   uint32_t frame_stats_time_{0};
@@ -110,41 +233,74 @@ class RemoteWebView : public Component {
   size_t   frame_stats_bytes_{0};
 
   QueueHandle_t     q_decode_{nullptr};
+  QueueHandle_t     q_ctl_{nullptr};
   SemaphoreHandle_t ws_send_mtx_{nullptr};
   TaskHandle_t      t_ws_{nullptr};
-  TaskHandle_t      t_decode_{nullptr};
 
   esp_websocket_client_handle_t ws_client_{nullptr};
 
+  // optional second connection for touch, flow control, stats and open-URL; frames stay on ws_client_
+  bool control_channel_{false};
+  SemaphoreHandle_t ctl_send_mtx_{nullptr};
+  esp_websocket_client_handle_t ctl_client_{nullptr};
+
   void start_ws_task_();
-  void start_decode_task_();
   static void ws_task_tramp_(void *arg);
-  static void decode_task_tramp_(void *arg);
 
   static void ws_event_handler_(void *handler_arg, esp_event_base_t base, int32_t event_id, void *event_data);
-  static void reasm_reset_(WsReasm &r);
+  void on_ws_event_(int32_t event_id, const esp_websocket_event_data_t *e);
+  static void ctl_event_handler_(void *handler_arg, esp_event_base_t base, int32_t event_id, void *event_data);
+  void on_ctl_event_(int32_t event_id, const esp_websocket_event_data_t *e);
+  void enqueue_message_(uint8_t *buf, size_t len, void *client);
+  bool enqueue_control_(const uint8_t *data, size_t len);
+  void enqueue_video_(uint8_t *buf, size_t len);
+  bool decode_next_();
+  void log_counters_();
+  void reasm_reset_(WsReasm &r);
 
-  void process_packet_(void *client, const uint8_t *data, size_t len);
+  void process_packet_(void *client, const uint8_t *data, size_t len, uint64_t rx_us);
   void process_frame_packet_(const uint8_t *data, size_t len);
+  bool priority_rect_(const proto::FrameInfo &fi, int &x0, int &y0, int &x1, int &y1) const;
   void process_frame_stats_packet_(const uint8_t *data, size_t len);
-  bool decode_jpeg_tile_to_lcd_(int16_t dst_x, int16_t dst_y, const uint8_t *data, size_t len);
-  bool decode_jpeg_tile_software_(int16_t dst_x, int16_t dst_y, const uint8_t *data, size_t len);
+  void process_pong_packet_(const uint8_t *data, size_t len, uint64_t rx_us);
+  void process_calibration_packet_(const uint8_t *data, size_t len);
+  void process_glyph_packet_(const uint8_t *data, size_t len);
+  void process_video_region_packet_(const uint8_t *data, size_t len);
+  void process_video_frame_(const WsMsg &m);
+  uint32_t measure_panel_ns_per_px_();
+  void record_present_latency_(uint64_t now);
+  void log_latency_stats_();
+  bool decode_jpeg_tile_to_lcd_(int16_t dst_x, int16_t dst_y, uint16_t dst_w, const uint8_t *data, size_t len, uint8_t shift);
+  bool decode_jpeg_tile_software_(int16_t dst_x, int16_t dst_y, uint16_t dst_w, const uint8_t *data, size_t len, uint8_t shift);
+  void region_mark_(const proto::TileView &th, uint32_t frame_id);
+  bool region_superseded_(const proto::TileView &th, uint32_t frame_id) const;
+  bool draw_raw_tile_(proto::Encoding enc, const proto::TileView &t);
+  void draw_rgb332_from_565_(int x, int y, int w, int h, const uint16_t *src, int stride);
+  void draw_gray_(int x, int y, int w, int h, const uint8_t *src, int stride);
+  void present_(int x, int y, int w, int h, const uint8_t *src, int stride_px,
+                display::ColorBitness bitness, bool big_endian);
+  void draw_upscaled_(int dst_x, int dst_y, int w, int h, const uint16_t *src, int stride, uint8_t shift);
 
   static int jpeg_draw_cb_s_(JPEGDRAW *p);
   int jpeg_draw_cb_(JPEGDRAW *p);
   JPEGDEC jd_;
 
+  bool ws_send_control_(const uint8_t *pkt, size_t n, TickType_t lock_to, TickType_t send_to, bool *via_ctl = nullptr);
   bool ws_send_touch_event_(proto::TouchType type, int x, int y, uint8_t pid);
   bool ws_send_keepalive_();
+  bool ws_send_stream_control_(bool pause);
+  bool ws_send_calibration_result_();
   bool ws_send_open_url_(const char *url, uint16_t flags);
 
   std::string resolve_device_id_() const;
   std::string build_ws_uri_() const;
+  std::string build_ctl_uri_() const;
   static void append_q_int_(std::string &s, const char *k, int v);
   static void append_q_float_(std::string &s, const char *k, float v);
   static void append_q_str_(std::string &s, const char *k, const char *v);
 
   friend class RemoteWebViewTouchListener;
+  friend class DecodePool;
 };
 
 class RemoteWebViewTouchListener : public touchscreen::TouchListener {
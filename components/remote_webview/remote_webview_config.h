@@ -1,4 +1,6 @@
 #pragma once
+#include <stddef.h>
+#include <stdint.h>
 
 namespace esphome {
 namespace remote_webview {
@@ -7,15 +9,58 @@ namespace cfg {
 inline constexpr int decode_task_stack = 32 * 1024;
 inline constexpr int ws_task_stack = 8 * 1024;
 inline constexpr int ws_task_prio = 5;
-inline constexpr int decode_queue_depth = 12;
+inline constexpr int ws_ctl_task_prio = 6;  // above the bulk stream so input is never parked behind a frame
+inline constexpr int decode_task_prio = 6;
+inline constexpr int decode_pool_workers = 1;
 
 inline constexpr size_t ws_max_message_bytes = 64 * 1024;
 inline constexpr size_t ws_buffer_size = 30 * 1024;
+inline constexpr size_t ws_buffer_size_min = 8 * 1024;
+inline constexpr size_t ws_ctl_buffer_size = 1024;
+// Pongs and stats requests are copied inline into their own queue, drained before any frame
+inline constexpr size_t ctl_msg_max = 32;
+inline constexpr int ctl_queue_depth = 8;
 inline constexpr size_t ws_keepalive_interval_us = 60 * 1000 * 1000;
+// keepalives double as clock-sync pings when latency stats are on
+inline constexpr size_t ws_ping_interval_us = 5 * 1000 * 1000;
+inline constexpr size_t counters_log_interval_us = 60 * 1000 * 1000;
+
+inline constexpr int refine_cell_px = 32;
+inline constexpr size_t convert_buf_px = 2048;
+
+// auto calibration
+inline constexpr size_t calibration_max_tiles = 16;
+inline constexpr int calibration_panel_rows = 16;
+inline constexpr uint32_t calibration_target_frame_ms = 250;
+inline constexpr uint32_t calibration_version = 1;
+
+// memory planner thresholds
+inline constexpr size_t plan_min_psram = 512 * 1024;
+inline constexpr size_t plan_tight_internal = 96 * 1024;
+// left free for Wi-Fi, lwIP and the rest of ESPHome whatever the budget
+inline constexpr size_t plan_internal_reserve = 48 * 1024;
+inline constexpr size_t strip_buffer_max = 32 * 1024;
+inline constexpr size_t msg_pool_slots_max = 32;
 
 inline constexpr bool coalesce_moves = true;
 inline constexpr uint32_t move_rate_hz = 60;
 
+// glyph cache (PSRAM)
+inline constexpr size_t glyph_atlas_bytes = 256 * 1024;
+inline constexpr size_t glyph_max = 2048;
+inline constexpr size_t glyph_bg_bytes = 256 * 1024;
+inline constexpr size_t glyph_bg_slots = 64;
+inline constexpr size_t glyph_run_max_px = 32 * 1024;
+
+// video region: a frame that waited longer than this is stale, the next one is already coming
+inline constexpr int video_queue_depth = 2;
+inline constexpr uint64_t video_max_age_us = 150 * 1000;
+
+// touch-priority scheduling: how long a touch steers tile order, and how far around it
+inline constexpr uint64_t touch_priority_window_us = 500 * 1000;
+inline constexpr int touch_priority_margin_px = 24;
+inline constexpr size_t priority_max_tiles = 256;
+
 } // namespace cfg
 } // namespace remote_webview
 } // namespace esphome
@@ -0,0 +1,141 @@
+// Stand-alone driver for LLVMFuzzerTestOneInput, for toolchains without libFuzzer.
+//   fuzz_main FILE...        replay inputs (e.g. a crash file from a libFuzzer run)
+//   fuzz_main [ITERS [SEED]] mutate well-formed seeds of every parsed message type
+#include "protocol.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <random>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t len);
+
+using namespace esphome::remote_webview;
+using Bytes = std::vector<uint8_t>;
+
+static void put16(Bytes &b, uint16_t v) { b.push_back((uint8_t)v); b.push_back((uint8_t)(v >> 8)); }
+static void put32(Bytes &b, uint32_t v) { put16(b, (uint16_t)v); put16(b, (uint16_t)(v >> 16)); }
+static void put64(Bytes &b, uint64_t v) { put32(b, (uint32_t)v); put32(b, (uint32_t)(v >> 32)); }
+static void head(Bytes &b, proto::MsgType t) { b.push_back((uint8_t)t); b.push_back(proto::kProtocolVersion); }
+
+// smallest baseline JPEG prefix jpeg_dimensions accepts: SOI, an APP0 to skip, SOF0
+static Bytes jpeg(uint16_t w, uint16_t h) {
+  return {0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x04, 0x00, 0x00, 0xFF, 0xC0, 0x00, 0x11, 0x08,
+          (uint8_t)(h >> 8), (uint8_t)h, (uint8_t)(w >> 8), (uint8_t)w, 0x03};
+}
+
+static std::vector<Bytes> seeds() {
+  std::vector<Bytes> out;
+
+  Bytes f;
+  head(f, proto::MsgType::Frame);
+  put32(f, 42);
+  f.push_back((uint8_t)proto::Encoding::JPEG);
+  put16(f, 2);
+  put16(f, proto::kFlafLastOfFrame | proto::kFlagHasCaptureTime | proto::kFlagHasPriorityRect);
+  put64(f, 123456789);
+  put16(f, 10); put16(f, 20); put16(f, 30); put16(f, 40);
+  for (int i = 0; i < 2; i++) {
+    const Bytes j = jpeg(64, 32);
+    put16(f, (uint16_t)(i * 64)); put16(f, 0); put16(f, 64); put16(f, 32); put32(f, (uint32_t)j.size());
+    f.insert(f.end(), j.begin(), j.end());
+  }
+  out.push_back(f);
+
+  Bytes c;
+  head(c, proto::MsgType::Calibration);
+  put16(c, 2);
+  for (int i = 0; i < 2; i++) {
+    const Bytes j = jpeg(128, 128);
+    put16(c, 128); c.push_back(80); put32(c, (uint32_t)j.size());
+    c.insert(c.end(), j.begin(), j.end());
+  }
+  out.push_back(c);
+
+  Bytes bg;
+  head(bg, proto::MsgType::Background);
+  bg.push_back(1);
+  put16(bg, 8); put16(bg, 8); put16(bg, 6); put16(bg, 4);
+  for (int i = 0; i < 6 * 4; i++) put16(bg, (uint16_t)(i * 2731));
+  out.push_back(bg);
+
+  Bytes tr;
+  head(tr, proto::MsgType::TextRun);
+  put16(tr, 8); put16(tr, 8); put16(tr, 6); put16(tr, 4);
+  tr.push_back(1); put16(tr, 0x1234); put16(tr, 3);
+  for (int i = 0; i < 3; i++) { put16(tr, (uint16_t)i); put16(tr, (uint16_t)(i * 3 - 2)); put16(tr, (uint16_t)-1); put16(tr, 0xF800); }
+  out.push_back(tr);
+
+  Bytes pong;
+  head(pong, proto::MsgType::Pong);
+  put64(pong, 1); put64(pong, 2); put64(pong, 3);
+  out.push_back(pong);
+
+  out.push_back(jpeg(800, 480));
+  return out;
+}
+
+static void mutate(std::mt19937 &rng, Bytes &b) {
+  static const uint32_t edge[] = {0, 1, 2, 0x7F, 0x80, 0xFF, 0x100, 0x7FFF, 0x8000, 0xFFFF, 0x7FFFFFFF, 0xFFFFFFFF};
+  const int rounds = 1 + rng() % 4;
+  for (int r = 0; r < rounds; r++) {
+    const size_t pos = b.empty() ? 0 : rng() % b.size();
+    switch (rng() % 6) {
+      case 0:  // bit flip
+        if (!b.empty()) b[pos] ^= (uint8_t)(1u << (rng() % 8));
+        break;
+      case 1:  // truncate
+        b.resize(b.empty() ? 0 : rng() % b.size());
+        break;
+      case 2:  // append garbage
+        for (int n = rng() % 16; n > 0; n--) b.push_back((uint8_t)rng());
+        break;
+      case 3:  // 16-bit boundary value over a length/count/coordinate
+        if (pos + 2 <= b.size()) { const uint32_t v = edge[rng() % 12]; b[pos] = (uint8_t)v; b[pos + 1] = (uint8_t)(v >> 8); }
+        break;
+      case 4:  // 32-bit boundary value, e.g. a tile dlen
+        if (pos + 4 <= b.size()) { const uint32_t v = edge[rng() % 12]; for (int k = 0; k < 4; k++) b[pos + k] = (uint8_t)(v >> (8 * k)); }
+        break;
+      default:  // erase a byte, shifting every later field
+        if (!b.empty()) b.erase(b.begin() + pos);
+        break;
+    }
+  }
+}
+
+static bool replay(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return false;
+  Bytes b;
+  int ch;
+  while ((ch = fgetc(f)) != EOF) b.push_back((uint8_t)ch);
+  fclose(f);
+  LLVMFuzzerTestOneInput(b.data(), b.size());
+  return true;
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1 && replay(argv[1])) {
+    for (int i = 2; i < argc; i++) replay(argv[i]);
+    printf("fuzz_main: replayed %d input(s)\n", argc - 1);
+    return 0;
+  }
+
+  const long iters = argc > 1 ? atol(argv[1]) : 200000;
+  std::mt19937 rng(argc > 2 ? (uint32_t)strtoul(argv[2], nullptr, 0) : 1);
+  const std::vector<Bytes> base = seeds();
+
+  for (const Bytes &s : base) LLVMFuzzerTestOneInput(s.data(), s.size());
+  for (long i = 0; i < iters; i++) {
+    Bytes b = base[rng() % base.size()];
+    mutate(rng, b);
+    // exact-size heap copy so ASan flags a read even one byte past the message
+    uint8_t *p = (uint8_t *)malloc(b.size() ? b.size() : 1);
+    if (!b.empty()) memcpy(p, b.data(), b.size());
+    LLVMFuzzerTestOneInput(p, b.size());
+    free(p);
+  }
+  printf("fuzz_main: %zu seeds, %ld mutated inputs, no crash\n", base.size(), iters);
+  return 0;
+}
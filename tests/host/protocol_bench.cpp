@@ -0,0 +1,125 @@
+// Times FrameView::parse plus tile iteration against the per-tile parse_tile_header loop it
+// replaced (reproduced below as it was before the change) on typical Frame messages.
+#include "protocol.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace esphome::remote_webview;
+
+namespace legacy {
+
+inline bool parse_frame_header(const uint8_t *data, size_t len, proto::FrameInfo &out, size_t &off) {
+  if (len < sizeof(proto::FrameHeader)) return false;
+
+  proto::FrameHeader h;
+  memcpy(&h, data, sizeof(h));
+
+  if (h.type != proto::MsgType::Frame || h.version != proto::kProtocolVersion) return false;
+
+  out.frame_id = proto::rd32(reinterpret_cast<const uint8_t*>(&h.frame_id));
+  out.enc = h.encoding;
+  out.tile_count = proto::rd16(reinterpret_cast<const uint8_t*>(&h.tile_count));
+  out.flags = proto::rd16(reinterpret_cast<const uint8_t*>(&h.flags));
+  out.capture_us = 0;
+  off = sizeof(proto::FrameHeader);
+
+  if (out.flags & proto::kFlagHasCaptureTime) {
+    if (len < off + 8) return false;
+    out.capture_us = proto::rd64(data + off);
+    off += 8;
+  }
+
+  return true;
+}
+
+inline bool parse_tile_header(const uint8_t *buf, size_t len, proto::TileHeader &out, size_t &off) {
+  if (!buf) return false;
+  if (off + sizeof(proto::TileHeader) > len) return false;
+
+  const uint8_t *th = buf + off;
+  out.x       = proto::rd16(th + 0);
+  out.y       = proto::rd16(th + 2);
+  out.w       = proto::rd16(th + 4);
+  out.h       = proto::rd16(th + 6);
+  out.dlen    = proto::rd32(th + 8);
+
+  off += sizeof(proto::TileHeader);
+  return true;
+}
+
+}  // namespace legacy
+
+static volatile uint32_t sink;
+
+// what process_frame_packet_ does per tile, minus the decode: read the rect and the payload pointer
+static uint32_t walk_legacy(const uint8_t *data, size_t len) {
+  proto::FrameInfo fi{};
+  size_t off = 0;
+  if (!legacy::parse_frame_header(data, len, fi, off)) return 0;
+  uint32_t acc = 0;
+  for (uint16_t i = 0; i < fi.tile_count; i++) {
+    proto::TileHeader th{};
+    if (!legacy::parse_tile_header(data, len, th, off)) return acc;
+    if (off + th.dlen > len) return acc;
+    acc += th.x + th.y + th.w + th.h + data[off];
+    off += th.dlen;
+  }
+  return acc;
+}
+
+static uint32_t walk_view(const uint8_t *data, size_t len) {
+  proto::FrameView fv;
+  if (!fv.parse(data, len)) return 0;
+  uint32_t acc = 0;
+  for (const proto::TileView &t : fv) acc += t.x + t.y + t.w + t.h + t.data[0];
+  return acc;
+}
+
+static std::vector<uint8_t> make_frame(int tiles, uint32_t tile_bytes) {
+  std::vector<uint8_t> b(sizeof(proto::FrameHeader));
+  b[0] = (uint8_t)proto::MsgType::Frame;
+  b[1] = proto::kProtocolVersion;
+  proto::wr32(&b[2], 7);
+  b[6] = (uint8_t)proto::Encoding::JPEG;
+  proto::wr16(&b[7], (uint16_t)tiles);
+  proto::wr16(&b[9], proto::kFlafLastOfFrame);
+  for (int i = 0; i < tiles; i++) {
+    const size_t at = b.size();
+    b.resize(at + sizeof(proto::TileHeader) + tile_bytes, 0xA5);
+    proto::wr16(&b[at], (uint16_t)(i % 15 * 32));
+    proto::wr16(&b[at + 2], (uint16_t)(i / 15 * 32));
+    proto::wr16(&b[at + 4], 32);
+    proto::wr16(&b[at + 6], 32);
+    proto::wr32(&b[at + 8], tile_bytes);
+  }
+  return b;
+}
+
+template<typename F> static double time_ns(const std::vector<uint8_t> &m, int iters, F &&walk) {
+  const auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < iters; i++) sink += walk(m.data(), m.size());
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / iters;
+}
+
+int main(int argc, char **argv) {
+  const int iters = argc > 1 ? atoi(argv[1]) : 200000;
+  printf("protocol_bench: parse + walk every tile of one Frame message, %d iterations\n", iters);
+
+  struct Case { const char *name; int tiles; uint32_t bytes; };
+  const Case cases[] = {{"1 full-frame tile", 1, 40000}, {"16 partial tiles", 16, 1500}, {"225 small tiles", 225, 200}};
+  for (const Case &c : cases) {
+    const std::vector<uint8_t> m = make_frame(c.tiles, c.bytes);
+    if (walk_legacy(m.data(), m.size()) != walk_view(m.data(), m.size())) {
+      fprintf(stderr, "%s: legacy and FrameView disagree\n", c.name);
+      return 1;
+    }
+    const double l = time_ns(m, iters, walk_legacy), v = time_ns(m, iters, walk_view);
+    printf("%-20s %8.1f ns legacy  %8.1f ns FrameView  %5.2fx\n", c.name, l, v, l / v);
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+// libFuzzer entry for everything that reads server bytes before they reach a decoder:
+// FrameView::parse plus tile iteration, the calibration/background/text-run/pong parsers,
+// jpeg_dimensions, and the glyph cache fed with whatever the parsers accept.
+// Build with `make fuzz` (clang) or replay/mutate with `make fuzz-smoke` (any compiler).
+#include "glyph_cache.h"
+#include "protocol.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+using namespace esphome::remote_webview;
+
+static volatile uint32_t sink;
+
+// touch the first and last byte of a span the parser claims is in bounds; ASan does the rest
+static void touch(const uint8_t *p, size_t n) {
+  if (n) sink += p[0] + p[n - 1];
+}
+
+static GlyphCache &cache() {
+  static GlyphCache c;
+  static bool ready = c.init(4096, 64, 8192, 4, 1024);
+  (void)ready;
+  return c;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t len) {
+  cache().clear();
+
+  proto::FrameView fv;
+  if (fv.parse(data, len)) {
+    uint32_t tiles = 0;
+    for (const proto::TileView &t : fv) {
+      touch(t.data, t.dlen);
+      uint16_t w, h;
+      if (proto::jpeg_dimensions(t.data, t.dlen, w, h)) sink += w + h;
+      tiles++;
+    }
+    if (tiles != fv.info().tile_count) __builtin_trap();
+  }
+
+  proto::CalibrationTile cal[8];
+  size_t count = 0;
+  if (proto::parse_calibration_packet(data, len, cal, 8, count))
+    for (size_t i = 0; i < count; i++) touch(cal[i].data, cal[i].dlen);
+
+  proto::BackgroundInfo bg{};
+  if (proto::parse_background_packet(data, len, bg)) {
+    touch(bg.pixels, (size_t)bg.w * bg.h * 2u);
+    cache().put_background(bg);
+  }
+
+  proto::TextRunInfo run{};
+  if (proto::parse_text_run_packet(data, len, run)) {
+    touch(run.glyphs, (size_t)run.count * sizeof(proto::TextRunGlyph));
+    // seed a glyph so compose() takes the blend path, not only the miss path
+    static const uint8_t alpha[16] = {0, 64, 128, 255, 255, 128, 64, 0, 0, 255, 0, 255, 1, 2, 254, 253};
+    cache().put_glyph(run.count ? proto::rd16(run.glyphs) % 64 : 0, 4, 4, alpha);
+    if (const uint16_t *px = cache().compose(run)) touch((const uint8_t *)px, (size_t)run.w * run.h * 2u);
+  }
+
+  proto::PongInfo pong{};
+  if (proto::parse_pong_packet(data, len, pong)) sink += (uint32_t)pong.server_tx_us;
+
+  uint16_t w, h;
+  if (proto::jpeg_dimensions(data, len, w, h)) sink += w + h;
+  return 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+// Host stand-in for bitbank2/JPEGDEC. It reads the frame size from the SOF marker and hands the
+// draw callback MCU-row blocks of a flat color derived from the compressed bytes, honoring the
+// pixel type and scale options; it does not entropy-decode. jpegdec_host_set_cost() adds a
+// per-output-pixel delay so the decode task can be made as slow as the target's.
+#include <stdint.h>
+
+enum { RGB565_LITTLE_ENDIAN = 0, RGB565_BIG_ENDIAN, EIGHT_BIT_GRAYSCALE, FOUR_BIT_DITHERED, TWO_BIT_DITHERED,
+       ONE_BIT_DITHERED, INVALID_PIXEL_TYPE };
+
+#define JPEG_AUTO_ROTATE    1
+#define JPEG_SCALE_HALF     2
+#define JPEG_SCALE_QUARTER  4
+#define JPEG_SCALE_EIGHTH   8
+#define JPEG_LE_PIXELS     16
+#define JPEG_EXIF_THUMBNAIL 32
+#define JPEG_LUMA_ONLY     64
+// the library decodes into a fixed pixel buffer of this size, whatever setMaxOutputSize() asks for
+#define MAX_BUFFERED_PIXELS 4096
+
+enum { JPEG_SUCCESS = 0, JPEG_INVALID_PARAMETER, JPEG_DECODE_ERROR, JPEG_UNSUPPORTED_FEATURE, JPEG_INVALID_FILE };
+
+struct JPEGDRAW {
+  int x, y;
+  int iWidth, iHeight;
+  int iBpp;
+  uint16_t *pPixels;
+  void *pUser;
+};
+
+typedef int(JPEG_DRAW_CALLBACK)(JPEGDRAW *pDraw);
+
+class JPEGDEC {
+ public:
+  int openRAM(uint8_t *pData, int iDataSize, JPEG_DRAW_CALLBACK *pfnDraw);
+  void close() { data_ = nullptr; }
+  int decode(int x, int y, int iOptions);
+  int getWidth() const { return width_; }
+  int getHeight() const { return height_; }
+  int getLastError() const { return last_error_; }
+  void setPixelType(int iType) { pixel_type_ = iType; }
+  void setMaxOutputSize(int iMaxMCUs) { max_mcus_ = iMaxMCUs > 0 ? iMaxMCUs : 1; }
+  void setUserPointer(void *p) { user_ = p; }
+
+ private:
+  const uint8_t *data_{nullptr};
+  int size_{0};
+  int width_{0}, height_{0};
+  int pixel_type_{RGB565_LITTLE_ENDIAN};
+  int max_mcus_{1};
+  int last_error_{JPEG_SUCCESS};
+  void *user_{nullptr};
+  JPEG_DRAW_CALLBACK *draw_{nullptr};
+};
+
+void jpegdec_host_set_cost(uint32_t ns_per_px);
@@ -0,0 +1,93 @@
+#include "JPEGDEC.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static std::atomic<uint32_t> cost_ns_per_px{0};
+
+void jpegdec_host_set_cost(uint32_t ns_per_px) { cost_ns_per_px = ns_per_px; }
+
+int JPEGDEC::openRAM(uint8_t *pData, int iDataSize, JPEG_DRAW_CALLBACK *pfnDraw) {
+  data_ = nullptr;
+  width_ = height_ = 0;
+  last_error_ = JPEG_INVALID_FILE;
+  if (!pData || iDataSize < 4 || pData[0] != 0xFF || pData[1] != 0xD8) return 0;
+
+  int off = 2;
+  while (off + 4 <= iDataSize) {
+    if (pData[off] != 0xFF) return 0;
+    const uint8_t marker = pData[off + 1];
+    const int seg = (pData[off + 2] << 8) | pData[off + 3];
+    if (marker == 0xC0 || marker == 0xC1 || marker == 0xC2) {
+      if (off + 9 > iDataSize) return 0;
+      height_ = (pData[off + 5] << 8) | pData[off + 6];
+      width_ = (pData[off + 7] << 8) | pData[off + 8];
+      break;
+    }
+    off += 2 + seg;
+  }
+  if (!width_ || !height_) return 0;
+
+  data_ = pData;
+  size_ = iDataSize;
+  draw_ = pfnDraw;
+  last_error_ = JPEG_SUCCESS;
+  return 1;
+}
+
+int JPEGDEC::decode(int x, int y, int iOptions) {
+  if (!data_ || !draw_) {
+    last_error_ = JPEG_INVALID_PARAMETER;
+    return 0;
+  }
+
+  int shift = 0;
+  if (iOptions & JPEG_SCALE_HALF) shift = 1;
+  if (iOptions & JPEG_SCALE_QUARTER) shift = 2;
+  if (iOptions & JPEG_SCALE_EIGHTH) shift = 3;
+  const int w = (width_ + (1 << shift) - 1) >> shift;
+  const int h = (height_ + (1 << shift) - 1) >> shift;
+  const int mcu = 16 >> shift;
+
+  // one band of whole MCU rows per callback, as wide as the image, within the MCU limit and the
+  // library's own pixel buffer
+  const int mcus_per_row = (width_ + 15) / 16;
+  int mcu_rows = std::min(max_mcus_ / mcus_per_row, MAX_BUFFERED_PIXELS / (w * mcu));
+  mcu_rows = std::max(1, std::min(mcu_rows, (h + mcu - 1) / mcu));
+  const int rows_per_cb = mcu_rows * mcu;
+
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < size_; i += 7) hash = (hash ^ data_[i]) * 16777619u;
+  const uint16_t rgb = (uint16_t)hash;
+  const uint8_t gray = (uint8_t)(hash >> 16);
+
+  const bool gray8 = pixel_type_ == EIGHT_BIT_GRAYSCALE;
+  std::vector<uint16_t> px((size_t)w * rows_per_cb);
+  if (gray8)
+    memset(px.data(), gray, px.size() * 2);
+  else
+    for (auto &p : px) p = pixel_type_ == RGB565_BIG_ENDIAN ? (uint16_t)((rgb >> 8) | (rgb << 8)) : rgb;
+
+  for (int r = 0; r < h; r += rows_per_cb) {
+    JPEGDRAW d{};
+    d.x = x;
+    d.y = y + r;
+    d.iWidth = w;
+    d.iHeight = rows_per_cb < h - r ? rows_per_cb : h - r;
+    d.iBpp = gray8 ? 8 : 16;
+    d.pPixels = px.data();
+    d.pUser = user_;
+    if (const uint32_t ns = cost_ns_per_px)
+      std::this_thread::sleep_for(std::chrono::nanoseconds((uint64_t)ns * d.iWidth * d.iHeight));
+    if (!draw_(&d)) {
+      last_error_ = JPEG_DECODE_ERROR;
+      return 0;
+    }
+  }
+  return 1;
+}
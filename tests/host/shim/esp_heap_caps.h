@@ -0,0 +1,64 @@
+#pragma once
+// Host stand-in for ESP-IDF's capability allocator: every region is plain malloc.
+// Free-size queries report a fixed internal RAM size and a PSRAM size minus what the process
+// has allocated, so the memory planner sees a plausible board and a leak shows up as shrinking
+// PSRAM. RWV_HOST_INTERNAL_KB and RWV_HOST_PSRAM_KB override the defaults.
+#include <malloc.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__SANITIZE_ADDRESS__)
+#define RWV_HOST_ASAN_ 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define RWV_HOST_ASAN_ 1
+#endif
+#endif
+#ifdef RWV_HOST_ASAN_
+extern "C" size_t __sanitizer_get_current_allocated_bytes(void);
+#endif
+
+#define MALLOC_CAP_8BIT     (1u << 2)
+#define MALLOC_CAP_DMA      (1u << 3)
+#define MALLOC_CAP_SPIRAM   (1u << 10)
+#define MALLOC_CAP_INTERNAL (1u << 11)
+
+inline void *heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+inline void *heap_caps_calloc(size_t n, size_t size, uint32_t) { return calloc(n, size); }
+inline void heap_caps_free(void *p) { free(p); }
+
+inline size_t host_heap_env_kb_(const char *name, size_t def) {
+  const char *v = getenv(name);
+  return (v && *v ? (size_t)strtoul(v, nullptr, 10) : def) * 1024u;
+}
+
+inline size_t host_heap_in_use() {
+  // ASan replaces malloc, so glibc's counters stay at zero; ask the sanitizer's allocator instead
+#ifdef RWV_HOST_ASAN_
+  return __sanitizer_get_current_allocated_bytes();
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  // large blocks are mmapped and counted apart from the arena
+  const struct mallinfo2 mi = mallinfo2();
+  return mi.uordblks + mi.hblkhd;
+#else
+  const struct mallinfo mi = mallinfo();
+  return (size_t)mi.uordblks + (size_t)mi.hblkhd;
+#endif
+}
+
+inline size_t heap_caps_get_free_size(uint32_t caps) {
+  static const size_t internal = host_heap_env_kb_("RWV_HOST_INTERNAL_KB", 320);
+  static const size_t psram = host_heap_env_kb_("RWV_HOST_PSRAM_KB", 8192);
+  if (!(caps & MALLOC_CAP_SPIRAM)) return internal;
+  const size_t used = host_heap_in_use();
+  return used < psram ? psram - used : 0;
+}
+
+inline size_t heap_caps_get_minimum_free_size(uint32_t caps) {
+  static size_t low = SIZE_MAX;
+  const size_t now = heap_caps_get_free_size(caps);
+  if (!(caps & MALLOC_CAP_SPIRAM)) return now;
+  if (now < low) low = now;
+  return low;
+}
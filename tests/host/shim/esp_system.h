@@ -0,0 +1,7 @@
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "esp_err.h"
+
+inline uint32_t esp_random() { return (uint32_t)random(); }
@@ -0,0 +1,10 @@
+#pragma once
+#include <stdint.h>
+#include <time.h>
+
+// microseconds on a monotonic clock, like the target's since-boot timer
+inline int64_t esp_timer_get_time() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
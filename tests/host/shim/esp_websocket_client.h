@@ -0,0 +1,83 @@
+#pragma once
+// Host implementation of the esp_websocket_client API over POSIX sockets (ws:// only).
+// Like the IDF client it runs one thread per connection, delivers each frame's payload in
+// reads of at most buffer_size bytes (payload_len/payload_offset describe the whole frame),
+// reconnects after reconnect_timeout_ms, and refuses stop() from inside its own handler.
+#include <stdint.h>
+
+#include "esp_err.h"
+#include "esp_event.h"
+#include "freertos/FreeRTOS.h"
+
+extern const char *WEBSOCKET_EVENTS;
+
+typedef enum {
+  WEBSOCKET_EVENT_ANY = -1,
+  WEBSOCKET_EVENT_ERROR = 0,
+  WEBSOCKET_EVENT_CONNECTED,
+  WEBSOCKET_EVENT_DISCONNECTED,
+  WEBSOCKET_EVENT_DATA,
+  WEBSOCKET_EVENT_CLOSED,
+  WEBSOCKET_EVENT_BEFORE_CONNECT,
+  WEBSOCKET_EVENT_MAX
+} esp_websocket_event_id_t;
+
+typedef enum {
+  WS_TRANSPORT_OPCODES_CONT = 0x00,
+  WS_TRANSPORT_OPCODES_TEXT = 0x01,
+  WS_TRANSPORT_OPCODES_BINARY = 0x02,
+  WS_TRANSPORT_OPCODES_CLOSE = 0x08,
+  WS_TRANSPORT_OPCODES_PING = 0x09,
+  WS_TRANSPORT_OPCODES_PONG = 0x0a,
+} ws_transport_opcodes_t;
+
+typedef enum {
+  WEBSOCKET_ERROR_TYPE_NONE = 0,
+  WEBSOCKET_ERROR_TYPE_TCP_TRANSPORT,
+  WEBSOCKET_ERROR_TYPE_PONG_TIMEOUT,
+  WEBSOCKET_ERROR_TYPE_HANDSHAKE,
+} esp_websocket_error_type_t;
+
+typedef struct {
+  esp_err_t esp_tls_last_esp_err;
+  int esp_tls_stack_err;
+  int esp_tls_cert_verify_flags;
+  esp_websocket_error_type_t error_type;
+  int esp_ws_handshake_status_code;
+  int esp_transport_sock_errno;
+} esp_websocket_error_codes_t;
+
+typedef struct esp_websocket_client *esp_websocket_client_handle_t;
+
+typedef struct {
+  const char *data_ptr;
+  int data_len;
+  bool fin;
+  uint8_t op_code;
+  esp_websocket_client_handle_t client;
+  void *user_context;
+  int payload_len;
+  int payload_offset;
+  esp_websocket_error_codes_t error_handle;
+} esp_websocket_event_data_t;
+
+typedef struct {
+  const char *uri;
+  int task_prio;
+  int task_stack;
+  int buffer_size;
+  bool disable_auto_reconnect;
+  int reconnect_timeout_ms;
+  int network_timeout_ms;
+} esp_websocket_client_config_t;
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t *config);
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t client, esp_websocket_event_id_t event,
+                                        esp_event_handler_t handler, void *handler_arg);
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_stop(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_set_uri(esp_websocket_client_handle_t client, const char *uri);
+bool esp_websocket_client_is_connected(esp_websocket_client_handle_t client);
+int esp_websocket_client_send_bin(esp_websocket_client_handle_t client, const char *data, int len,
+                                  TickType_t timeout);
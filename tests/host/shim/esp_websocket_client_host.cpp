@@ -0,0 +1,381 @@
+#include "esp_websocket_client.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+const char *WEBSOCKET_EVENTS = "WEBSOCKET_EVENTS";
+
+struct esp_websocket_client {
+  std::mutex cfg_mtx;
+  std::string host, path;
+  int port{80};
+
+  size_t buffer_size{1024};
+  int reconnect_ms{10000};
+  int network_ms{10000};
+  bool auto_reconnect{true};
+
+  esp_event_handler_t handler{nullptr};
+  void *handler_arg{nullptr};
+
+  std::thread th;
+  std::thread::id th_id;
+  std::atomic<bool> run{false};
+  std::atomic<bool> connected{false};
+  std::atomic<int> fd{-1};
+  std::mutex send_mtx;
+  std::mt19937 rng{std::random_device{}()};
+};
+
+static bool parse_uri_(esp_websocket_client *c, const char *uri) {
+  if (!uri || strncmp(uri, "ws://", 5) != 0) return false;
+  const std::string s(uri + 5);
+  const size_t slash = s.find('/');
+  const std::string hostport = s.substr(0, slash);
+  const size_t colon = hostport.rfind(':');
+
+  std::lock_guard<std::mutex> lk(c->cfg_mtx);
+  c->host = hostport.substr(0, colon);
+  c->port = colon == std::string::npos ? 80 : atoi(hostport.c_str() + colon + 1);
+  c->path = slash == std::string::npos ? "/" : s.substr(slash);
+  return !c->host.empty() && c->port > 0;
+}
+
+static void dispatch_(esp_websocket_client *c, int32_t id, esp_websocket_event_data_t *d) {
+  d->client = c;
+  d->user_context = c->handler_arg;
+  if (c->handler) c->handler(c->handler_arg, WEBSOCKET_EVENTS, id, d);
+}
+
+static void dispatch_simple_(esp_websocket_client *c, int32_t id, esp_websocket_error_type_t err = WEBSOCKET_ERROR_TYPE_NONE) {
+  esp_websocket_event_data_t d{};
+  d.error_handle.error_type = err;
+  d.error_handle.esp_transport_sock_errno = errno;
+  dispatch_(c, id, &d);
+}
+
+// waits for the socket in short slices so stop() is noticed without closing the fd under a reader
+static bool wait_fd_(esp_websocket_client *c, int fd, short events, int timeout_ms) {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (c->run) {
+    pollfd p{fd, events, 0};
+    const int r = poll(&p, 1, 100);
+    if (r > 0) return true;
+    if (r < 0 && errno != EINTR) return false;
+    if (timeout_ms >= 0 && std::chrono::steady_clock::now() >= deadline) return false;
+  }
+  return false;
+}
+
+// reads up to n bytes (at least 1); 0 on close, error or stop
+static size_t read_some_(esp_websocket_client *c, int fd, uint8_t *buf, size_t n) {
+  for (;;) {
+    if (!wait_fd_(c, fd, POLLIN, -1)) return 0;
+    const ssize_t r = recv(fd, buf, n, 0);
+    if (r > 0) return (size_t)r;
+    if (r < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+    return 0;
+  }
+}
+
+static bool read_exact_(esp_websocket_client *c, int fd, uint8_t *buf, size_t n) {
+  while (n) {
+    const size_t r = read_some_(c, fd, buf, n);
+    if (!r) return false;
+    buf += r;
+    n -= r;
+  }
+  return true;
+}
+
+static bool write_all_(int fd, const uint8_t *buf, size_t n) {
+  while (n) {
+    const ssize_t r = send(fd, buf, n, MSG_NOSIGNAL);
+    if (r < 0 && errno == EINTR) continue;
+    if (r <= 0) return false;
+    buf += r;
+    n -= (size_t)r;
+  }
+  return true;
+}
+
+static int connect_(esp_websocket_client *c) {
+  std::string host, path;
+  int port;
+  {
+    std::lock_guard<std::mutex> lk(c->cfg_mtx);
+    host = c->host;
+    path = c->path;
+    port = c->port;
+  }
+
+  addrinfo hints{}, *res = nullptr;
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &res) != 0 || !res) return -1;
+
+  const int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+  if (fd < 0) {
+    freeaddrinfo(res);
+    return -1;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  int rc = connect(fd, res->ai_addr, res->ai_addrlen);
+  freeaddrinfo(res);
+  if (rc < 0 && errno == EINPROGRESS && wait_fd_(c, fd, POLLOUT, c->network_ms)) {
+    int err = 0;
+    socklen_t len = sizeof(err);
+    getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len);
+    rc = err ? -1 : 0;
+  }
+  if (rc < 0) {
+    close(fd);
+    return -1;
+  }
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+  const int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  // the key only has to be unique; the server's accept hash is not checked
+  char key[25];
+  static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  for (int i = 0; i < 22; i++) key[i] = b64[c->rng() % 64];
+  key[22] = key[23] = '=';
+  key[24] = 0;
+
+  char req[1024];
+  const int n = snprintf(req, sizeof(req),
+                         "GET %s HTTP/1.1\r\nHost: %s:%d\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                         "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n",
+                         path.c_str(), host.c_str(), port, key);
+  if (n <= 0 || n >= (int)sizeof(req) || !write_all_(fd, (const uint8_t *)req, (size_t)n)) {
+    close(fd);
+    return -1;
+  }
+
+  // byte at a time so no frame data is consumed with the headers
+  std::string resp;
+  uint8_t ch;
+  while (resp.size() < 4096 && (resp.size() < 4 || resp.compare(resp.size() - 4, 4, "\r\n\r\n") != 0)) {
+    if (!wait_fd_(c, fd, POLLIN, c->network_ms) || recv(fd, &ch, 1, 0) != 1) {
+      close(fd);
+      return -1;
+    }
+    resp += (char)ch;
+  }
+  if (resp.compare(0, 12, "HTTP/1.1 101") != 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+static bool send_frame_(esp_websocket_client *c, int fd, uint8_t opcode, const uint8_t *data, size_t len) {
+  uint8_t hdr[14];
+  size_t h = 0;
+  hdr[h++] = (uint8_t)(0x80 | opcode);
+  if (len < 126) {
+    hdr[h++] = (uint8_t)(0x80 | len);
+  } else if (len <= 0xFFFF) {
+    hdr[h++] = 0x80 | 126;
+    hdr[h++] = (uint8_t)(len >> 8);
+    hdr[h++] = (uint8_t)len;
+  } else {
+    hdr[h++] = 0x80 | 127;
+    for (int i = 7; i >= 0; i--) hdr[h++] = (uint8_t)((uint64_t)len >> (8 * i));
+  }
+  const uint32_t mask = c->rng();
+  memcpy(hdr + h, &mask, 4);
+  const uint8_t *m = hdr + h;
+  h += 4;
+
+  std::vector<uint8_t> frame(hdr, hdr + h);
+  frame.resize(h + len);
+  for (size_t i = 0; i < len; i++) frame[h + i] = data[i] ^ m[i & 3];
+  return write_all_(fd, frame.data(), frame.size());
+}
+
+static void session_(esp_websocket_client *c, int fd) {
+  std::vector<uint8_t> buf(c->buffer_size);
+  for (;;) {
+    uint8_t h[2];
+    if (!read_exact_(c, fd, h, 2)) return;
+    const uint8_t opcode = h[0] & 0x0F;
+    const bool fin = (h[0] & 0x80) != 0;
+    uint64_t len = h[1] & 0x7F;
+    if (len == 126) {
+      uint8_t e[2];
+      if (!read_exact_(c, fd, e, 2)) return;
+      len = ((uint64_t)e[0] << 8) | e[1];
+    } else if (len == 127) {
+      uint8_t e[8];
+      if (!read_exact_(c, fd, e, 8)) return;
+      len = 0;
+      for (int i = 0; i < 8; i++) len = (len << 8) | e[i];
+    }
+    uint8_t mask[4] = {0, 0, 0, 0};
+    const bool masked = (h[1] & 0x80) != 0;
+    if (masked && !read_exact_(c, fd, mask, 4)) return;
+
+    if (opcode >= 0x8) {
+      // control frames are small and handled whole
+      std::vector<uint8_t> p((size_t)len);
+      if (len && !read_exact_(c, fd, p.data(), p.size())) return;
+      if (masked)
+        for (size_t i = 0; i < p.size(); i++) p[i] ^= mask[i & 3];
+      if (opcode == WS_TRANSPORT_OPCODES_PING) {
+        std::lock_guard<std::mutex> lk(c->send_mtx);
+        send_frame_(c, fd, WS_TRANSPORT_OPCODES_PONG, p.data(), p.size());
+      }
+      esp_websocket_event_data_t d{};
+      d.data_ptr = (const char *)p.data();
+      d.data_len = (int)p.size();
+      d.payload_len = (int)p.size();
+      d.fin = true;
+      d.op_code = opcode;
+      dispatch_(c, WEBSOCKET_EVENT_DATA, &d);
+      if (opcode == WS_TRANSPORT_OPCODES_CLOSE) {
+        std::lock_guard<std::mutex> lk(c->send_mtx);
+        send_frame_(c, fd, WS_TRANSPORT_OPCODES_CLOSE, p.data(), p.size() < 2 ? p.size() : 2);
+        return;
+      }
+      continue;
+    }
+
+    uint64_t off = 0;
+    do {
+      const size_t want = (size_t)std::min<uint64_t>(len - off, buf.size());
+      const size_t got = want ? read_some_(c, fd, buf.data(), want) : 0;
+      if (want && !got) return;
+      if (masked)
+        for (size_t i = 0; i < got; i++) buf[i] ^= mask[(off + i) & 3];
+
+      esp_websocket_event_data_t d{};
+      d.data_ptr = (const char *)buf.data();
+      d.data_len = (int)got;
+      d.fin = fin;
+      d.op_code = opcode;
+      d.payload_len = (int)len;
+      d.payload_offset = (int)off;
+      dispatch_(c, WEBSOCKET_EVENT_DATA, &d);
+      off += got;
+    } while (off < len);
+  }
+}
+
+static void task_(esp_websocket_client *c) {
+  while (c->run) {
+    const int fd = connect_(c);
+    if (fd >= 0) {
+      c->fd = fd;
+      c->connected = true;
+      dispatch_simple_(c, WEBSOCKET_EVENT_CONNECTED);
+      session_(c, fd);
+      {
+        std::lock_guard<std::mutex> lk(c->send_mtx);
+        c->connected = false;
+        c->fd = -1;
+        close(fd);
+      }
+      if (!c->run) break;
+      dispatch_simple_(c, WEBSOCKET_EVENT_DISCONNECTED, WEBSOCKET_ERROR_TYPE_TCP_TRANSPORT);
+    } else if (c->run) {
+      dispatch_simple_(c, WEBSOCKET_EVENT_ERROR, WEBSOCKET_ERROR_TYPE_TCP_TRANSPORT);
+    }
+    if (!c->auto_reconnect) break;
+    for (int waited = 0; c->run && waited < c->reconnect_ms; waited += 50)
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+  c->run = false;
+}
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t *config) {
+  auto *c = new esp_websocket_client;
+  if (!config || !parse_uri_(c, config->uri)) {
+    delete c;
+    return nullptr;
+  }
+  if (config->buffer_size > 0) c->buffer_size = (size_t)config->buffer_size;
+  if (config->reconnect_timeout_ms > 0) c->reconnect_ms = config->reconnect_timeout_ms;
+  if (config->network_timeout_ms > 0) c->network_ms = config->network_timeout_ms;
+  c->auto_reconnect = !config->disable_auto_reconnect;
+  return c;
+}
+
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t c, esp_websocket_event_id_t,
+                                        esp_event_handler_t handler, void *handler_arg) {
+  if (!c) return ESP_ERR_INVALID_ARG;
+  c->handler = handler;
+  c->handler_arg = handler_arg;
+  return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t c) {
+  if (!c) return ESP_ERR_INVALID_ARG;
+  if (c->run) return ESP_FAIL;  // already started
+  if (c->th.joinable()) {
+    if (std::this_thread::get_id() == c->th_id) return ESP_FAIL;
+    c->th.join();
+  }
+  c->run = true;
+  c->th = std::thread(task_, c);
+  c->th_id = c->th.get_id();
+  return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_stop(esp_websocket_client_handle_t c) {
+  if (!c) return ESP_ERR_INVALID_ARG;
+  // same rule as the IDF client: the handler runs on the client's own thread
+  if (c->th.joinable() && std::this_thread::get_id() == c->th_id) return ESP_FAIL;
+  if (!c->run && !c->th.joinable()) return ESP_FAIL;
+  c->run = false;
+  if (c->th.joinable()) c->th.join();
+  return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t c) {
+  if (!c) return ESP_ERR_INVALID_ARG;
+  esp_websocket_client_stop(c);
+  delete c;
+  return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_set_uri(esp_websocket_client_handle_t c, const char *uri) {
+  return c && parse_uri_(c, uri) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+bool esp_websocket_client_is_connected(esp_websocket_client_handle_t c) { return c && c->connected; }
+
+int esp_websocket_client_send_bin(esp_websocket_client_handle_t c, const char *data, int len, TickType_t timeout) {
+  if (!c || !data || len < 0) return -1;
+  std::unique_lock<std::mutex> lk(c->send_mtx, std::defer_lock);
+  if (timeout == portMAX_DELAY) {
+    lk.lock();
+  } else {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+    while (!lk.try_lock()) {
+      if (std::chrono::steady_clock::now() >= deadline) return -1;
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+  }
+  const int fd = c->fd;
+  if (!c->connected || fd < 0) return -1;
+  return send_frame_(c, fd, WS_TRANSPORT_OPCODES_BINARY, (const uint8_t *)data, (size_t)len) ? len : -1;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+
+namespace esphome {
+
+struct Color {
+  uint8_t r{0}, g{0}, b{0}, w{0};
+  Color() = default;
+  Color(uint8_t r, uint8_t g, uint8_t b, uint8_t w = 0) : r(r), g(g), b(b), w(w) {}
+};
+
+namespace display {
+
+enum ColorOrder : uint8_t { COLOR_ORDER_RGB = 0, COLOR_ORDER_BGR = 1, COLOR_ORDER_GRB = 2 };
+enum ColorBitness : uint8_t { COLOR_BITNESS_888 = 0, COLOR_BITNESS_565 = 1, COLOR_BITNESS_332 = 2 };
+
+// The slice of esphome::display::Display the component draws through; a test subclasses it.
+class Display {
+ public:
+  virtual ~Display() = default;
+  virtual int get_width() = 0;
+  virtual int get_height() = 0;
+
+  virtual void draw_pixel_at(int x, int y, Color color) = 0;
+  virtual void draw_pixels_at(int x_start, int y_start, int w, int h, const uint8_t *ptr, ColorOrder order,
+                              ColorBitness bitness, bool big_endian, int x_offset, int y_offset, int x_pad) = 0;
+  void draw_pixels_at(int x_start, int y_start, int w, int h, const uint8_t *ptr, ColorOrder order,
+                      ColorBitness bitness, bool big_endian) {
+    this->draw_pixels_at(x_start, y_start, w, h, ptr, order, bitness, big_endian, 0, 0, 0);
+  }
+};
+
+}  // namespace display
+}  // namespace esphome
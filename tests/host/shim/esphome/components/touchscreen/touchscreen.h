@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+
+#include <vector>
+
+namespace esphome {
+namespace touchscreen {
+
+enum TouchPointState : uint8_t { STATE_RELEASED = 0, STATE_PRESSED = 1, STATE_UPDATED = 2, STATE_RELEASING = 4 };
+
+struct TouchPoint {
+  uint8_t id{0};
+  int16_t x_raw{0}, y_raw{0}, z_raw{0};
+  uint16_t x_prev{0}, y_prev{0};
+  uint16_t x_org{0}, y_org{0};
+  uint16_t x{0}, y{0};
+  int8_t state{STATE_RELEASED};
+};
+
+using TouchPoints_t = std::vector<TouchPoint>;
+
+class TouchListener {
+ public:
+  virtual ~TouchListener() = default;
+  virtual void touch(TouchPoint /*tp*/) {}
+  virtual void update(const TouchPoints_t &/*tpoints*/) {}
+  virtual void release() {}
+};
+
+// Listener registry only; a test drives the listeners the way ESPHome's touch loop does.
+class Touchscreen {
+ public:
+  virtual ~Touchscreen() = default;
+  void register_listener(TouchListener *listener) { this->touch_listeners_.push_back(listener); }
+
+ protected:
+  std::vector<TouchListener *> touch_listeners_;
+};
+
+}  // namespace touchscreen
+}  // namespace esphome
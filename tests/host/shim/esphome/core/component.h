@@ -0,0 +1,27 @@
+#pragma once
+#include <string>
+
+namespace esphome {
+
+namespace setup_priority {
+inline constexpr float HARDWARE = 800.0f;
+inline constexpr float PROCESSOR = 400.0f;
+inline constexpr float LATE = -100.0f;
+}  // namespace setup_priority
+
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return 0.0f; }
+
+  void mark_failed() { failed_ = true; }
+  bool is_failed() const { return failed_; }
+
+ protected:
+  bool failed_{false};
+};
+
+}  // namespace esphome
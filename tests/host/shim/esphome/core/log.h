@@ -0,0 +1,19 @@
+#pragma once
+// ESP_LOGx for host builds: stdout with a monotonic timestamp. RWV_LOG_LEVEL picks the
+// most verbose level printed (E=1 W=2 I=3 D=4 V=5, also the letters); the default is D.
+
+namespace esphome {
+
+enum { ESPHOME_LOG_LEVEL_NONE = 0, ESPHOME_LOG_LEVEL_ERROR, ESPHOME_LOG_LEVEL_WARN, ESPHOME_LOG_LEVEL_INFO,
+       ESPHOME_LOG_LEVEL_CONFIG, ESPHOME_LOG_LEVEL_DEBUG, ESPHOME_LOG_LEVEL_VERBOSE };
+
+void host_log(int level, const char *tag, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+}  // namespace esphome
+
+#define ESP_LOGE(tag, ...) ::esphome::host_log(::esphome::ESPHOME_LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::host_log(::esphome::ESPHOME_LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::host_log(::esphome::ESPHOME_LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::host_log(::esphome::ESPHOME_LOG_LEVEL_CONFIG, tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::host_log(::esphome::ESPHOME_LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::host_log(::esphome::ESPHOME_LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
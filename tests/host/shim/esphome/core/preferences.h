@@ -0,0 +1,64 @@
+#pragma once
+// In-memory preferences: values survive a reconnect but not the process. ESPHome's preferences
+// are only safe from the main loop, so touching them from any other thread aborts the run.
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace esphome {
+
+// the thread that runs setup() and loop(); static init happens on it
+inline const std::thread::id host_main_thread = std::this_thread::get_id();
+
+inline void host_prefs_check_thread_(const char *what) {
+  if (std::this_thread::get_id() == host_main_thread) return;
+  fprintf(stderr, "[soak] FAIL: preferences %s called off the main loop\n", what);
+  fflush(stderr);
+  abort();
+}
+
+class ESPPreferenceObject {
+ public:
+  ESPPreferenceObject() = default;
+  ESPPreferenceObject(std::vector<uint8_t> *slot) : slot_(slot) {}
+
+  template<typename T> bool save(const T *src) {
+    host_prefs_check_thread_("save()");
+    if (!slot_) return false;
+    slot_->assign((const uint8_t *)src, (const uint8_t *)src + sizeof(T));
+    return true;
+  }
+  template<typename T> bool load(T *dest) {
+    host_prefs_check_thread_("load()");
+    if (!slot_ || slot_->size() != sizeof(T)) return false;
+    memcpy(dest, slot_->data(), sizeof(T));
+    return true;
+  }
+
+ private:
+  std::vector<uint8_t> *slot_{nullptr};
+};
+
+class ESPPreferences {
+ public:
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool /*in_flash*/ = false) {
+    host_prefs_check_thread_("make_preference()");
+    return ESPPreferenceObject(&store_[type]);
+  }
+  bool sync() {
+    host_prefs_check_thread_("sync()");
+    return true;
+  }
+
+ private:
+  std::map<uint32_t, std::vector<uint8_t>> store_;
+};
+
+extern ESPPreferences *global_preferences;
+
+}  // namespace esphome
@@ -0,0 +1,52 @@
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <mutex>
+
+namespace esphome {
+
+static ESPPreferences host_preferences;
+ESPPreferences *global_preferences = &host_preferences;
+
+static int log_level_() {
+  const char *v = getenv("RWV_LOG_LEVEL");
+  if (!v || !*v) return ESPHOME_LOG_LEVEL_DEBUG;
+  switch (v[0]) {
+    case 'E': case 'e': return ESPHOME_LOG_LEVEL_ERROR;
+    case 'W': case 'w': return ESPHOME_LOG_LEVEL_WARN;
+    case 'I': case 'i': return ESPHOME_LOG_LEVEL_INFO;
+    case 'C': case 'c': return ESPHOME_LOG_LEVEL_CONFIG;
+    case 'D': case 'd': return ESPHOME_LOG_LEVEL_DEBUG;
+    case 'V': case 'v': return ESPHOME_LOG_LEVEL_VERBOSE;
+    default: break;
+  }
+  // numeric levels follow ESP-IDF's E=1 ... V=5, where ESPHome puts CONFIG in between
+  const int n = atoi(v);
+  return n >= 4 ? n + 1 : n;
+}
+
+void host_log(int level, const char *tag, const char *fmt, ...) {
+  static const int max_level = log_level_();
+  if (level > max_level) return;
+
+  static const char letters[] = "?EWICDV";
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  static std::mutex mtx;
+  std::lock_guard<std::mutex> lk(mtx);
+  printf("[%6ld.%03ld][%c][%s] ", (long)ts.tv_sec, ts.tv_nsec / 1000000, letters[level], tag);
+  va_list ap;
+  va_start(ap, fmt);
+  vprintf(fmt, ap);
+  va_end(ap);
+  putchar('\n');
+  fflush(stdout);
+}
+
+}  // namespace esphome
@@ -0,0 +1,109 @@
+#include "freertos/FreeRTOS.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct HostQueue {
+  std::mutex mtx;
+  std::condition_variable not_empty, not_full;
+  size_t cap, item_size, head{0}, count{0};
+  std::vector<uint8_t> data;
+};
+
+struct HostTask {
+  std::thread th;
+};
+
+template<typename Pred> static bool wait_for_(std::condition_variable &cv, std::unique_lock<std::mutex> &lk,
+                                              TickType_t wait, Pred pred) {
+  if (wait == portMAX_DELAY) {
+    cv.wait(lk, pred);
+    return true;
+  }
+  return cv.wait_for(lk, std::chrono::milliseconds(wait), pred);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  if (!length) return nullptr;
+  auto *q = new HostQueue;
+  q->cap = length;
+  q->item_size = item_size;
+  q->data.resize((size_t)length * item_size);
+  return q;
+}
+
+void vQueueDelete(QueueHandle_t q) { delete q; }
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t wait) {
+  if (!q) return pdFALSE;
+  std::unique_lock<std::mutex> lk(q->mtx);
+  if (!wait_for_(q->not_full, lk, wait, [q] { return q->count < q->cap; })) return pdFALSE;
+  if (q->item_size) memcpy(&q->data[((q->head + q->count) % q->cap) * q->item_size], item, q->item_size);
+  q->count++;
+  lk.unlock();
+  q->not_empty.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t wait) {
+  if (!q) return pdFALSE;
+  std::unique_lock<std::mutex> lk(q->mtx);
+  if (!wait_for_(q->not_empty, lk, wait, [q] { return q->count > 0; })) return pdFALSE;
+  if (q->item_size) memcpy(item, &q->data[q->head * q->item_size], q->item_size);
+  q->head = (q->head + 1) % q->cap;
+  q->count--;
+  lk.unlock();
+  q->not_full.notify_one();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) {
+  if (!q) return 0;
+  std::lock_guard<std::mutex> lk(q->mtx);
+  return (UBaseType_t)q->count;
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) {
+  SemaphoreHandle_t s = xQueueCreate(max, 0);
+  if (s) s->count = initial;
+  return s;
+}
+SemaphoreHandle_t xSemaphoreCreateBinary() { return xSemaphoreCreateCounting(1, 0); }
+SemaphoreHandle_t xSemaphoreCreateMutex() { return xSemaphoreCreateCounting(1, 1); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t wait) { return xQueueReceive(s, nullptr, wait); }
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) { return xQueueSend(s, nullptr, 0); }
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t, void *arg, UBaseType_t,
+                                   TaskHandle_t *out, BaseType_t) {
+  // stack size, priority and core are the target's business; host threads get the OS defaults
+  auto *t = new HostTask;
+  t->th = std::thread([fn, arg] { fn(arg); });
+  if (name) {
+    char n[16];
+    strncpy(n, name, sizeof(n) - 1);
+    n[sizeof(n) - 1] = 0;
+    pthread_setname_np(t->th.native_handle(), n);
+  }
+  t->th.detach();
+  if (out) *out = t;
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio,
+                       TaskHandle_t *out) {
+  return xTaskCreatePinnedToCore(fn, name, stack, arg, prio, out, tskNO_AFFINITY);
+}
+
+void vTaskDelay(TickType_t ticks) { std::this_thread::sleep_for(std::chrono::milliseconds(ticks)); }
+
+TickType_t xTaskGetTickCount() {
+  using namespace std::chrono;
+  return (TickType_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,66 @@
+#!/bin/sh
+# Starts the stub server, runs the host client against it, and checks both sides.
+#   run_soak.sh CLIENT [client options...]
+# SERVER_ARGS are passed to stub_server.py, PORT picks the port (default 8765).
+# The client's last drop counters are printed; MAX_QUEUE_DROPS turns them into a pass/fail limit.
+# A requested feature that setup disabled fails the run unless ALLOW_DISABLED is set.
+# The server must see touches unless the client was given --touch-hz 0.
+set -u
+
+CLIENT=$1
+shift
+HERE=$(dirname "$0")
+PORT=${PORT:-8765}
+LOG=${LOG:-soak_server.log}
+CLIENT_LOG=${CLIENT_LOG:-soak_client.log}
+
+python3 "$HERE/stub_server.py" --port "$PORT" ${SERVER_ARGS:-} >"$LOG" 2>&1 &
+SERVER=$!
+trap 'kill $SERVER 2>/dev/null' EXIT INT TERM
+
+for _ in 1 2 3 4 5 6 7 8 9 10; do
+  grep -q listening "$LOG" && break
+  sleep 0.2
+done
+
+"$CLIENT" --server "127.0.0.1:$PORT" "$@" 2>&1 | tee "$CLIENT_LOG"
+RC=$(grep -q '^\[soak\] FAIL' "$CLIENT_LOG" && echo 1 || echo 0)
+grep -q '^\[soak\] done' "$CLIENT_LOG" || RC=1
+
+kill -TERM $SERVER 2>/dev/null
+wait $SERVER 2>/dev/null
+trap - EXIT INT TERM
+cat "$LOG"
+
+SUMMARY=$(grep '^\[server\] summary:' "$LOG")
+case " $* " in
+  *" --touch-hz 0 "*) ;;
+  *) echo "$SUMMARY" | grep -Eq 'touch_(main|ctl)=[1-9]' || { echo "[soak] FAIL: server saw no touches"; RC=1; } ;;
+esac
+echo "$SUMMARY" | grep -Eq 'frames=[1-9]' || { echo "[soak] FAIL: server sent no frames"; RC=1; }
+
+# a feature the run asked for but setup turned off means the run did not test it
+DISABLED=$(grep -E '\]\[[WE]\]\[Remote_WebView\] .*(disabling|drawing synchronously|falling back)' "$CLIENT_LOG")
+if [ -n "$DISABLED" ]; then
+  echo "$DISABLED"
+  if [ -n "${ALLOW_DISABLED:-}" ]; then
+    echo "[soak] WARN: requested features were disabled at setup"
+  else
+    echo "[soak] FAIL: requested features were disabled at setup (ALLOW_DISABLED=1 to accept)"
+    RC=1
+  fi
+fi
+case " $* " in
+  *" --control-channel "*)
+    echo "$SUMMARY" | grep -Eq 'connect_ctl=[1-9]' || { echo "[soak] FAIL: no control-socket connection"; RC=1; } ;;
+esac
+
+DROPS=$(grep '\[stats\] dropped:' "$CLIENT_LOG" | tail -n 1 | sed 's/.*dropped: //')
+echo "[soak] client drops: ${DROPS:-none reported}"
+if [ -n "${MAX_QUEUE_DROPS:-}" ]; then
+  QF=$(echo "$DROPS" | sed -n 's/.*queue_full=\([0-9]*\).*/\1/p')
+  [ "${QF:-0}" -le "$MAX_QUEUE_DROPS" ] || { echo "[soak] FAIL: $QF queue-full drops (limit $MAX_QUEUE_DROPS)"; RC=1; }
+fi
+
+[ $RC -eq 0 ] && echo "[soak] PASS" || echo "[soak] FAIL"
+exit $RC
@@ -0,0 +1,260 @@
+// Runs the full remote_webview client on the host against a stub server (see stub_server.py):
+// the real WebSocket task, reassembly, decode pool, blit stage and touch path, drawing into a
+// mock display and fed by a scripted touchscreen. It prints a summary every --report seconds
+// and fails on out-of-bounds draws, on a run that drew nothing, or on heap growth past
+// --max-growth-kb between the end of warm-up and the end of the run.
+#include "remote_webview.h"
+
+#include "JPEGDEC.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace esphome;
+
+namespace {
+
+// Counts what reaches the panel and checks every draw against its bounds. --panel-ns-per-px
+// makes draw_pixels_at take as long as an SPI or RGB bus would.
+class MockDisplay : public display::Display {
+ public:
+  MockDisplay(int w, int h, uint32_t ns_per_px) : w_(w), h_(h), ns_per_px_(ns_per_px) {}
+
+  int get_width() override { return w_; }
+  int get_height() override { return h_; }
+
+  void draw_pixel_at(int x, int y, Color) override {
+    check_(x, y, 1, 1);
+    pixels_++;
+    single_++;
+  }
+
+  void draw_pixels_at(int x, int y, int w, int h, const uint8_t *ptr, display::ColorOrder, display::ColorBitness bitness,
+                      bool, int, int, int x_pad) override {
+    check_(x, y, w, h);
+    if (!ptr || x_pad < 0) bad_++;
+    // touch the last byte the panel would read, so a short source buffer trips ASan
+    const size_t bpp = bitness == display::COLOR_BITNESS_332 ? 1u : 2u;
+    if (ptr && w > 0 && h > 0) sink_ += ptr[((size_t)(h - 1) * (w + x_pad) + (w - 1)) * bpp];
+    pixels_ += (uint64_t)w * h;
+    blits_++;
+    if (ns_per_px_) std::this_thread::sleep_for(std::chrono::nanoseconds((uint64_t)ns_per_px_ * w * h));
+  }
+
+  uint64_t pixels() const { return pixels_; }
+  uint64_t blits() const { return blits_; }
+  uint64_t single() const { return single_; }
+  uint64_t bad() const { return bad_; }
+
+ private:
+  void check_(int x, int y, int w, int h) {
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > w_ || y + h > h_) {
+      if (bad_++ < 10) fprintf(stderr, "[soak] out-of-bounds draw %dx%d@%d,%d\n", w, h, x, y);
+    }
+  }
+
+  const int w_, h_;
+  const uint32_t ns_per_px_;
+  std::atomic<uint64_t> pixels_{0}, blits_{0}, single_{0}, bad_{0};
+  std::atomic<uint32_t> sink_{0};
+};
+
+// Plays taps and short drags through the listeners in the order ESPHome's touch loop uses.
+class MockTouchscreen : public touchscreen::Touchscreen {
+ public:
+  void gesture(int x0, int y0, int x1, int y1, int moves) {
+    touchscreen::TouchPoint tp;
+    tp.x = (uint16_t)x0;
+    tp.y = (uint16_t)y0;
+    tp.state = touchscreen::STATE_PRESSED;
+    for (auto *l : touch_listeners_) l->touch(tp);
+    for (auto *l : touch_listeners_) l->update({tp});
+
+    tp.state = touchscreen::STATE_UPDATED;
+    for (int i = 1; i <= moves; i++) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+      tp.x = (uint16_t)(x0 + (x1 - x0) * i / moves);
+      tp.y = (uint16_t)(y0 + (y1 - y0) * i / moves);
+      for (auto *l : touch_listeners_) l->update({tp});
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    for (auto *l : touch_listeners_) l->release();
+    gestures_++;
+  }
+
+  uint32_t gestures() const { return gestures_; }
+
+ private:
+  uint32_t gestures_{0};
+};
+
+struct Options {
+  std::string server{"127.0.0.1:8765"};
+  int duration_s{60};
+  int report_s{10};
+  int width{480}, height{480};
+  double touch_hz{0.5};
+  uint32_t panel_ns_per_px{0};
+  uint32_t decode_ns_per_px{0};
+  long max_growth_kb{1024};
+  int max_bytes_per_msg{-1};
+  int memory_budget{-1};
+  int decode_workers{-1};
+  bool control_channel{false};
+  bool async_blit{false};
+  bool latency_stats{false};
+  bool touch_priority{false};
+  bool auto_calibrate{false};
+  int preview_quality{-1};
+};
+
+void usage(const char *argv0) {
+  fprintf(stderr,
+          "usage: %s [--server HOST:PORT] [--duration S] [--report S] [--size WxH] [--touch-hz N]\n"
+          "          [--panel-ns-per-px N] [--decode-ns-per-px N] [--max-growth-kb N]\n"
+          "          [--max-bytes-per-msg N] [--memory-budget N] [--decode-workers N] [--preview-quality N]\n"
+          "          [--control-channel] [--async-blit] [--latency-stats] [--touch-priority]\n"
+          "          [--auto-calibrate]\n",
+          argv0);
+  exit(2);
+}
+
+Options parse(int argc, char **argv) {
+  Options o;
+  for (int i = 1; i < argc; i++) {
+    const std::string a = argv[i];
+    auto val = [&]() -> const char * {
+      if (i + 1 >= argc) usage(argv[0]);
+      return argv[++i];
+    };
+    if (a == "--server") o.server = val();
+    else if (a == "--duration") o.duration_s = atoi(val());
+    else if (a == "--report") o.report_s = atoi(val());
+    else if (a == "--size") { if (sscanf(val(), "%dx%d", &o.width, &o.height) != 2) usage(argv[0]); }
+    else if (a == "--touch-hz") o.touch_hz = atof(val());
+    else if (a == "--panel-ns-per-px") o.panel_ns_per_px = (uint32_t)atol(val());
+    else if (a == "--decode-ns-per-px") o.decode_ns_per_px = (uint32_t)atol(val());
+    else if (a == "--max-growth-kb") o.max_growth_kb = atol(val());
+    else if (a == "--max-bytes-per-msg") o.max_bytes_per_msg = atoi(val());
+    else if (a == "--memory-budget") o.memory_budget = atoi(val());
+    else if (a == "--decode-workers") o.decode_workers = atoi(val());
+    else if (a == "--preview-quality") o.preview_quality = atoi(val());
+    else if (a == "--control-channel") o.control_channel = true;
+    else if (a == "--async-blit") o.async_blit = true;
+    else if (a == "--latency-stats") o.latency_stats = true;
+    else if (a == "--touch-priority") o.touch_priority = true;
+    else if (a == "--auto-calibrate") o.auto_calibrate = true;
+    else usage(argv[0]);
+  }
+  if (o.duration_s <= 0 || o.report_s <= 0 || o.width <= 0 || o.height <= 0) usage(argv[0]);
+  return o;
+}
+
+long rss_kb() {
+  FILE *f = fopen("/proc/self/statm", "r");
+  if (!f) return 0;
+  long pages = 0, resident = 0;
+  if (fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+  fclose(f);
+  return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const Options o = parse(argc, argv);
+  setvbuf(stdout, nullptr, _IOLBF, 0);
+  jpegdec_host_set_cost(o.decode_ns_per_px);
+
+  MockDisplay disp(o.width, o.height, o.panel_ns_per_px);
+  MockTouchscreen touch;
+  auto *rwv = new remote_webview::RemoteWebView();
+  rwv->set_display(&disp);
+  rwv->set_touchscreen(&touch);
+  rwv->set_server(o.server);
+  rwv->set_device_id("soak-" + std::to_string(getpid()));
+  rwv->set_max_bytes_per_msg(o.max_bytes_per_msg);
+  rwv->set_memory_budget(o.memory_budget);
+  rwv->set_decode_workers(o.decode_workers);
+  rwv->set_preview_quality(o.preview_quality);
+  rwv->set_control_channel(o.control_channel);
+  rwv->set_async_blit(o.async_blit);
+  rwv->set_latency_stats(o.latency_stats);
+  rwv->set_touch_priority(o.touch_priority);
+  rwv->set_auto_calibrate(o.auto_calibrate);
+
+  rwv->setup();
+  if (rwv->is_failed()) {
+    fprintf(stderr, "[soak] setup failed\n");
+    return 1;
+  }
+  rwv->dump_config();
+
+  const int64_t t0 = esp_timer_get_time();
+  const int64_t warmup_us = std::min<int64_t>(30, std::max(5, o.duration_s / 10)) * 1000000LL;
+  const int64_t touch_every_us = o.touch_hz > 0 ? (int64_t)(1e6 / o.touch_hz) : 0;
+  int64_t next_touch = t0 + 2000000, next_report = t0 + o.report_s * 1000000LL;
+  long base_heap_kb = -1;
+  uint32_t seed = 1;
+
+  for (;;) {
+    const int64_t now = esp_timer_get_time();
+    if (now - t0 >= o.duration_s * 1000000LL) break;
+
+    if (touch_every_us && now >= next_touch) {
+      next_touch = now + touch_every_us;
+      seed = seed * 1103515245u + 12345u;
+      const int x = (int)(seed >> 8) % o.width, y = (int)(seed >> 16) % o.height;
+      // every other gesture is a short drag, the rest are taps
+      const bool drag = (seed >> 4) & 1;
+      touch.gesture(x, y, drag ? (x + o.width / 4) % o.width : x, y, drag ? 8 : 0);
+    }
+
+    if (base_heap_kb < 0 && now - t0 >= warmup_us) base_heap_kb = (long)(host_heap_in_use() / 1024);
+
+    if (now >= next_report) {
+      next_report += o.report_s * 1000000LL;
+      printf("[soak] t=%llds pixels=%llu blits=%llu pixel_calls=%llu bad_draws=%llu gestures=%u heap=%zuKB rss=%ldKB\n",
+             (long long)((now - t0) / 1000000), (unsigned long long)disp.pixels(), (unsigned long long)disp.blits(),
+             (unsigned long long)disp.single(), (unsigned long long)disp.bad(), touch.gestures(),
+             host_heap_in_use() / 1024, rss_kb());
+    }
+    rwv->loop();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+
+  rwv->log_counters();
+  const long end_heap_kb = (long)(host_heap_in_use() / 1024);
+  if (base_heap_kb < 0) base_heap_kb = end_heap_kb;  // run ended inside warm-up: nothing to compare
+  const long growth = end_heap_kb - base_heap_kb;
+  printf("[soak] done: %ds pixels=%llu blits=%llu bad_draws=%llu gestures=%u heap %ldKB -> %ldKB (%+ldKB) rss=%ldKB\n",
+         o.duration_s, (unsigned long long)disp.pixels(), (unsigned long long)disp.blits(),
+         (unsigned long long)disp.bad(), touch.gestures(), base_heap_kb, end_heap_kb, growth, rss_kb());
+
+  int rc = 0;
+  if (!disp.pixels()) {
+    fprintf(stderr, "[soak] FAIL: nothing was drawn\n");
+    rc = 1;
+  }
+  if (disp.bad()) {
+    fprintf(stderr, "[soak] FAIL: %llu bad draws\n", (unsigned long long)disp.bad());
+    rc = 1;
+  }
+  if (growth > o.max_growth_kb) {
+    fprintf(stderr, "[soak] FAIL: heap grew %ld KB after warm-up (limit %ld KB)\n", growth, o.max_growth_kb);
+    rc = 1;
+  }
+  // the client's tasks never exit; skip static destructors they might still be using
+  fflush(stdout);
+  fflush(stderr);
+  _exit(rc);
+}
@@ -0,0 +1,410 @@
+#!/usr/bin/env python3
+"""Stub Remote WebView server for host soak runs (Python 3 stdlib only).
+
+Streams synthetic frames, or frames replayed from a recording, to remote_webview clients
+over WebSocket at a configurable rate, tile count and message size. It can split every
+message into small TCP writes so the client sees it in many reads. It answers pings with
+pongs, asks for frame stats, honours pause/resume, and counts touches per socket. A summary
+is printed on exit (SIGINT/SIGTERM or --duration).
+
+Synthetic tiles are "JPEGs" that only carry SOI + SOF0 + padding: enough for the client's
+header checks and for the host JPEGDEC stand-in, which does not entropy-decode.
+
+Recordings (--replay) are a sequence of [len:4 little-endian][message bytes] records, one
+server->client WebSocket message each, e.g. captured from a real server.
+"""
+
+import argparse
+import base64
+import hashlib
+import random
+import signal
+import socket
+import struct
+import sys
+import threading
+import time
+import urllib.parse
+
+GUID = b"258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+MSG_FRAME, MSG_TOUCH, MSG_FRAME_STATS, MSG_OPEN_URL, MSG_KEEPALIVE, MSG_PONG, MSG_PAUSE, MSG_RESUME = range(1, 9)
+MSG_CALIBRATION, MSG_CAL_RESULT = 9, 10
+PROTO_VER = 1
+ENC_JPEG = 2
+FLAG_LAST = 1 << 0
+FLAG_FULL = 1 << 1
+FLAG_CAPTURE = 1 << 5
+
+FRAME_HDR = 11
+TILE_HDR = 12
+
+
+def now_us():
+    return time.monotonic_ns() // 1000
+
+
+class Stats:
+    def __init__(self):
+        self.lock = threading.Lock()
+        self.c = {}
+
+    def add(self, key, n=1):
+        with self.lock:
+            self.c[key] = self.c.get(key, 0) + n
+
+    def line(self):
+        with self.lock:
+            return " ".join("%s=%d" % kv for kv in sorted(self.c.items()))
+
+
+STATS = Stats()
+
+
+def fake_jpeg(w, h, size, rnd):
+    sof = bytes([0xFF, 0xC0, 0x00, 0x11, 0x08, h >> 8, h & 0xFF, w >> 8, w & 0xFF, 0x03,
+                 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01])
+    head = b"\xFF\xD8" + sof
+    body = max(0, size - len(head) - 2)
+    return head + rnd.randbytes(body) + b"\xFF\xD9"
+
+
+def calibration_sweep(rnd):
+    """Test tiles for a client that connected with cal=1: two tile sizes at three qualities."""
+    entries = []
+    for ts in (32, 64):
+        for q in (40, 70, 90):
+            jpeg = fake_jpeg(ts, ts, ts * ts * q // 200, rnd)
+            entries.append(struct.pack("<HBI", ts, q, len(jpeg)) + jpeg)
+    return struct.pack("<BBH", MSG_CALIBRATION, PROTO_VER, len(entries)) + b"".join(entries)
+
+
+class Conn:
+    """One accepted WebSocket; send() writes a whole message, optionally in slices."""
+
+    def __init__(self, sock, args):
+        self.sock = sock
+        self.args = args
+        self.send_lock = threading.Lock()
+        self.alive = True
+
+    def send(self, payload, opcode=0x2):
+        n = len(payload)
+        if n < 126:
+            hdr = struct.pack("!BB", 0x80 | opcode, n)
+        elif n <= 0xFFFF:
+            hdr = struct.pack("!BBH", 0x80 | opcode, 126, n)
+        else:
+            hdr = struct.pack("!BBQ", 0x80 | opcode, 127, n)
+        data = hdr + payload
+        frag = self.args.fragment
+        with self.send_lock:
+            try:
+                if frag <= 0:
+                    self.sock.sendall(data)
+                else:
+                    for i in range(0, len(data), frag):
+                        self.sock.sendall(data[i:i + frag])
+                        if self.args.fragment_delay_ms:
+                            time.sleep(self.args.fragment_delay_ms / 1000.0)
+            except OSError:
+                self.alive = False
+                return False
+        STATS.add("bytes_sent", len(data))
+        return True
+
+    def recv_exact(self, n):
+        buf = b""
+        while len(buf) < n:
+            chunk = self.sock.recv(n - len(buf))
+            if not chunk:
+                raise ConnectionError("closed")
+            buf += chunk
+        return buf
+
+    def recv_message(self):
+        h = self.recv_exact(2)
+        opcode = h[0] & 0x0F
+        n = h[1] & 0x7F
+        if n == 126:
+            n = struct.unpack("!H", self.recv_exact(2))[0]
+        elif n == 127:
+            n = struct.unpack("!Q", self.recv_exact(8))[0]
+        mask = self.recv_exact(4) if h[1] & 0x80 else b"\0\0\0\0"
+        data = bytearray(self.recv_exact(n))
+        for i in range(n):
+            data[i] ^= mask[i & 3]
+        return opcode, bytes(data)
+
+
+class Session:
+    """State shared by a client's frame socket and its optional control socket."""
+
+    def __init__(self, sid):
+        self.id = sid
+        self.paused = False
+        self.want_full = True
+
+
+SESSIONS = {}
+SESSIONS_LOCK = threading.Lock()
+
+
+def session_for(sid):
+    with SESSIONS_LOCK:
+        return SESSIONS.setdefault(sid, Session(sid))
+
+
+def handshake(sock):
+    req = b""
+    while b"\r\n\r\n" not in req:
+        chunk = sock.recv(1024)
+        if not chunk:
+            return None
+        req += chunk
+        if len(req) > 16384:
+            return None
+    lines = req.split(b"\r\n")
+    path = lines[0].split(b" ")[1].decode()
+    key = None
+    for line in lines[1:]:
+        if line.lower().startswith(b"sec-websocket-key:"):
+            key = line.split(b":", 1)[1].strip()
+    if key is None:
+        return None
+    accept = base64.b64encode(hashlib.sha1(key + GUID).digest())
+    sock.sendall(b"HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                 b"Sec-WebSocket-Accept: " + accept + b"\r\n\r\n")
+    return urllib.parse.parse_qs(urllib.parse.urlparse(path).query)
+
+
+def reader(conn, sess, channel):
+    try:
+        while conn.alive:
+            opcode, data = conn.recv_message()
+            if opcode == 0x8:
+                conn.send(data[:2], opcode=0x8)
+                break
+            if opcode == 0x9:
+                conn.send(data, opcode=0xA)
+                continue
+            if opcode != 0x2 or len(data) < 2:
+                continue
+            t = data[0]
+            if t == MSG_TOUCH:
+                STATS.add("touch_%s" % channel)
+            elif t == MSG_KEEPALIVE:
+                STATS.add("keepalive")
+                if len(data) >= 10:
+                    rx = now_us()
+                    client_us = struct.unpack_from("<Q", data, 2)[0]
+                    conn.send(struct.pack("<BBQQQ", MSG_PONG, PROTO_VER, client_us, rx, now_us()))
+            elif t == MSG_FRAME_STATS:
+                STATS.add("frame_stats")
+            elif t == MSG_OPEN_URL:
+                STATS.add("open_url")
+                sess.want_full = True
+            elif t == MSG_PAUSE:
+                STATS.add("pause")
+                sess.paused = True
+            elif t == MSG_RESUME:
+                STATS.add("resume")
+                sess.paused = False
+                sess.want_full = True
+            elif t == MSG_CAL_RESULT:
+                STATS.add("calibration_result")
+            else:
+                STATS.add("unknown_%d" % t)
+    except (OSError, ConnectionError):
+        pass
+    conn.alive = False
+
+
+class FrameSource:
+    def __init__(self, args, width, height, max_msg, latency):
+        self.args = args
+        self.w, self.h = width, height
+        self.max_msg = max_msg
+        self.latency = latency
+        self.frame_id = 0
+        self.rnd = random.Random(args.seed)
+        self.replay = []
+        self.replay_pos = 0
+        if args.replay:
+            with open(args.replay, "rb") as f:
+                blob = f.read()
+            off = 0
+            while off + 4 <= len(blob):
+                (n,) = struct.unpack_from("<I", blob, off)
+                self.replay.append(blob[off + 4:off + 4 + n])
+                off += 4 + n
+            if not self.replay:
+                sys.exit("empty recording: %s" % args.replay)
+
+    def grid(self):
+        ts = self.args.tile_size
+        return [(x, y, min(ts, self.w - x), min(ts, self.h - y))
+                for y in range(0, self.h, ts) for x in range(0, self.w, ts)]
+
+    def next_frame(self, full):
+        """Returns the messages of one frame."""
+        if self.replay:
+            msg = self.replay[self.replay_pos % len(self.replay)]
+            self.replay_pos += 1
+            return [msg]
+
+        self.frame_id = (self.frame_id + 1) & 0xFFFFFFFF
+        cells = self.grid()
+        if not full:
+            cells = self.rnd.sample(cells, min(self.args.tiles, len(cells)))
+        tiles = []
+        for (x, y, w, h) in cells:
+            size = max(32, int(self.args.tile_bytes * self.rnd.uniform(1 - self.args.jitter, 1 + self.args.jitter)))
+            jpeg = fake_jpeg(w, h, size, self.rnd)
+            tiles.append(struct.pack("<HHHHI", x, y, w, h, len(jpeg)) + jpeg)
+
+        flags = FLAG_FULL if full else 0
+        extra = b""
+        if self.latency:
+            flags |= FLAG_CAPTURE
+            extra = struct.pack("<Q", now_us())
+        head_len = FRAME_HDR + len(extra)
+
+        # pack tiles into messages no larger than the client's limit
+        groups, cur, cur_len = [], [], head_len
+        for t in tiles:
+            if cur and cur_len + len(t) > self.max_msg:
+                groups.append(cur)
+                cur, cur_len = [], head_len
+            cur.append(t)
+            cur_len += len(t)
+        groups.append(cur)
+
+        msgs = []
+        for i, g in enumerate(groups):
+            f = flags | (FLAG_LAST if i == len(groups) - 1 else 0)
+            hdr = struct.pack("<BBIBHH", MSG_FRAME, PROTO_VER, self.frame_id, ENC_JPEG, len(g), f)
+            msgs.append(hdr + extra + b"".join(g))
+        return msgs
+
+
+def serve(sock, addr, args):
+    params = handshake(sock)
+    if params is None:
+        sock.close()
+        return
+    sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+    sid = params.get("id", ["?"])[0]
+    sess = session_for(sid)
+    conn = Conn(sock, args)
+    channel = "ctl" if params.get("ch", [""])[0] == "ctl" else "main"
+    STATS.add("connect_%s" % channel)
+    print("[server] %s connected from %s:%d (%s)" % (sid, addr[0], addr[1], channel), flush=True)
+
+    t = threading.Thread(target=reader, args=(conn, sess, channel), daemon=True)
+    t.start()
+    if channel == "ctl":
+        t.join()
+        sock.close()
+        return
+
+    width = int(params.get("w", [480])[0])
+    height = int(params.get("h", [480])[0])
+    max_msg = int(params.get("mbpm", [64 * 1024])[0])
+    latency = params.get("lat", ["0"])[0] == "1"
+    src = FrameSource(args, width, height, max_msg, latency)
+    if params.get("cal", ["0"])[0] == "1":
+        conn.send(calibration_sweep(random.Random(args.seed)))
+        STATS.add("calibration")
+    sess.want_full = True
+
+    interval = 1.0 / args.fps if args.fps > 0 else 0
+    next_t = time.monotonic()
+    next_stats = time.monotonic() + args.stats_every
+    frames = 0
+    while conn.alive:
+        if args.fps > 0:
+            next_t += interval
+            delay = next_t - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+            else:
+                next_t = time.monotonic()  # behind: do not burst to catch up
+        if args.stats_every and time.monotonic() >= next_stats:
+            next_stats += args.stats_every
+            conn.send(bytes([MSG_FRAME_STATS, PROTO_VER]))
+        if sess.paused:
+            if args.fps <= 0:
+                time.sleep(0.05)
+            continue
+
+        frames += 1
+        full = sess.want_full or (args.full_every and frames % args.full_every == 0)
+        sess.want_full = False
+        for m in src.next_frame(full):
+            if not conn.send(m):
+                break
+            STATS.add("messages")
+        STATS.add("frames")
+
+        if args.oversize_every and frames % args.oversize_every == 0:
+            # one message above the client's limit; it must be dropped, not crash or stall
+            conn.send(struct.pack("<BBIBHH", MSG_FRAME, PROTO_VER, 0, ENC_JPEG, 0, FLAG_LAST) + bytes(max_msg + 1024))
+            STATS.add("oversize")
+
+        if args.drop_every and frames % args.drop_every == 0:
+            print("[server] dropping %s to force a reconnect" % sid, flush=True)
+            STATS.add("forced_drops")
+            conn.alive = False
+            try:
+                sock.shutdown(socket.SHUT_RDWR)
+            except OSError:
+                pass
+    sock.close()
+    print("[server] %s disconnected after %d frames" % (sid, frames), flush=True)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--host", default="127.0.0.1")
+    ap.add_argument("--port", type=int, default=8765)
+    ap.add_argument("--fps", type=float, default=20, help="frames per second; 0 = as fast as the socket takes them")
+    ap.add_argument("--tile-size", type=int, default=64, help="tile edge in pixels")
+    ap.add_argument("--tiles", type=int, default=8, help="tiles in a partial frame")
+    ap.add_argument("--tile-bytes", type=int, default=2500, help="mean encoded bytes per tile")
+    ap.add_argument("--jitter", type=float, default=0.3, help="+/- fraction applied to --tile-bytes")
+    ap.add_argument("--full-every", type=int, default=50, help="send a full frame every N frames (0 = only on connect)")
+    ap.add_argument("--fragment", type=int, default=0, help="write each message in TCP slices of N bytes")
+    ap.add_argument("--fragment-delay-ms", type=float, default=0, help="pause between slices")
+    ap.add_argument("--oversize-every", type=int, default=0, help="every N frames send a message over the client's limit")
+    ap.add_argument("--drop-every", type=int, default=0, help="every N frames drop the connection")
+    ap.add_argument("--stats-every", type=float, default=5, help="seconds between frame-stats requests (0 = never)")
+    ap.add_argument("--replay", help="recording of server messages to loop instead of synthetic frames")
+    ap.add_argument("--duration", type=float, default=0, help="exit after N seconds (0 = until signalled)")
+    ap.add_argument("--seed", type=int, default=1)
+    args = ap.parse_args()
+
+    srv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    srv.bind((args.host, args.port))
+    srv.listen(8)
+    srv.settimeout(0.5)
+    print("[server] listening on %s:%d" % (args.host, srv.getsockname()[1]), flush=True)
+
+    stop = threading.Event()
+    signal.signal(signal.SIGTERM, lambda *_: stop.set())
+    signal.signal(signal.SIGINT, lambda *_: stop.set())
+    deadline = time.monotonic() + args.duration if args.duration > 0 else None
+
+    while not stop.is_set() and (deadline is None or time.monotonic() < deadline):
+        try:
+            sock, addr = srv.accept()
+        except socket.timeout:
+            continue
+        threading.Thread(target=serve, args=(sock, addr, args), daemon=True).start()
+
+    print("[server] summary: " + STATS.line(), flush=True)
+
+
+if __name__ == "__main__":
+    main()